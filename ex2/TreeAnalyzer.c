@@ -10,12 +10,26 @@
 */
 
 // ------------------------------ includes ------------------------------
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <ctype.h>
 #include <string.h>
-#include "queue.h"
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 // -------------------------- const definitions -------------------------
 
 /**
@@ -48,6 +62,25 @@
 */
 #define MAX_ROW_LENGTH 1024
 
+/**
+* @def WEIGHT_SEPARATOR ':'
+* @brief  separates a neighbor in a row of the input text file from the weight of the edge to it, as in "3:10". A
+* weight is a strictly positive integer
+*/
+#define WEIGHT_SEPARATOR ':'
+
+/**
+* @def DEFAULT_EDGE_WEIGHT 1
+* @brief  the weight of an edge written without a weight, and of every edge of a binary graph file
+*/
+#define DEFAULT_EDGE_WEIGHT 1
+
+/**
+* @def MAX_WEIGHT_DIGITS 9
+* @brief  the maximal amount of digits of an edge weight, so the weight of a path fits in a long long
+*/
+#define MAX_WEIGHT_DIGITS 9
+
 /**
 * @def IS_LEAF "-"
 * @brief  representing a leaf in the input text file
@@ -109,942 +142,9750 @@
 */
 #define  DIAMETER_LENGTH_MSG "Diameter Length: "
 
+/**
+* @def ARENA_FIRST_BLOCK_SIZE 65536
+* @brief  the size of the first block of an arena, every following block is twice as large
+*/
+#define ARENA_FIRST_BLOCK_SIZE 65536
 
-// ------------------------------ Structures -----------------------------
+/**
+* @def ARENA_MAX_BLOCK_SIZE 67108864
+* @brief  blocks of an arena stop growing at this size (64MB)
+*/
+#define ARENA_MAX_BLOCK_SIZE 67108864
 
 /**
- * @brief represents A vertex
- * */
-typedef struct Vertex
-{
-    struct Vertex *next; /* representing all the connected with distance of 1 vertexs*/
-    int vertexKey; /* the numerical id of the vertex **/
+* @def ARENA_ALIGNMENT 16
+* @brief  every allocation from an arena is aligned to this amount of bytes
+*/
+#define ARENA_ALIGNMENT 16
 
-} Vertex;
+/**
+* @def THREADS_ENV_VAR "TREE_ANALYZER_THREADS"
+* @brief  the environment variable overriding the amount of threads used for parallel work
+*/
+#define THREADS_ENV_VAR "TREE_ANALYZER_THREADS"
 
 /**
- * @brief represents a graph
- **/
-typedef struct Graph
-{
-    Vertex **listOfAdjacent; /** represents infomration of adjecnt connected vertex for each vertex in the graph**/
-    Vertex **listOfAncestors; /** represents  for every vertex from which other vertex they were attached**/
-    int *visited; /** Represents for each vertex whenever it was visted.Used in bfs**/
-    int verticesCount; /** represents the total amount of vertices in the graph **/
-    int edgesCount; /** represents the total edge count**/
-    int root; /** represents the index of the root**/
-    bool hasCycle; /** represents whenver the graph contains a cycle.Used in the bfs algorithm**/
-} Graph;
+* @def RELABEL_ENV_VAR "TREE_ANALYZER_RELABEL"
+* @brief  the environment variable selecting the order the vertices are relabeled in before the analysis
+*/
+#define RELABEL_ENV_VAR "TREE_ANALYZER_RELABEL"
 
 /**
- * @brief an array represents for a given vertex v the distance to every other vertex in a given graph.
- * Each index in the array represnts the index of the vertex.
- **/
-typedef int *DistanceFromNode;
+* @def RELABEL_BFS "bfs"
+* @brief  the value of the relabel environment variable ordering the vertices as a bfs from the root reaches them
+*/
+#define RELABEL_BFS "bfs"
 
-// ------------------------------ function prototype --------------------
+/**
+* @def RELABEL_RCM "rcm"
+* @brief  the value of the relabel environment variable ordering the vertices in reverse Cuthill-McKee order
+*/
+#define RELABEL_RCM "rcm"
 
-int validateVertexAmountLine(char *str);
+/**
+* @def MAX_THREADS 256
+* @brief  the maximal amount of threads used for parallel work
+*/
+#define MAX_THREADS 256
 
-bool validateVertexEdgeLine(char *line, int rowIndex, int numOfVertices);
+/**
+* @def PARALLEL_BFS_MIN_VERTICES 65536
+* @brief  graphs with less vertices are traversed on a single thread, as threads would only add overhead
+*/
+#define PARALLEL_BFS_MIN_VERTICES 65536
 
-bool parseGraphFile(char ***vertexAdjContent, int *numOfVertices, char *file);
+/**
+* @def SEQUENTIAL_STEP_MAX_FRONTIER 1024
+* @brief  frontiers smaller than this are expanded on a single thread
+*/
+#define SEQUENTIAL_STEP_MAX_FRONTIER 1024
 
-int findLeafIndex(Graph *graph);
+/**
+* @def TOP_DOWN_ALPHA 14
+* @brief  bfs switches to bottom up steps once the frontier has more than 1/TOP_DOWN_ALPHA of the unexplored edges
+*/
+#define TOP_DOWN_ALPHA 14
 
-void setRootVertexKey(Graph *graph);
+/**
+* @def BOTTOM_UP_BETA 24
+* @brief  bfs switches back to top down steps once the frontier has less than 1/BOTTOM_UP_BETA of the vertices
+*/
+#define BOTTOM_UP_BETA 24
 
-int getVertexDeg(Graph *graph, int vertexKey);
+/**
+* @def BITS_PER_WORD 64
+* @brief  the amount of vertices represented by a single word of a bitmap
+*/
+#define BITS_PER_WORD 64
 
-void attachEdges(Graph *graph, char **contentToAttach);
+/**
+* @def MODE_FLAG_INDEX 1
+* @brief Represents the index of the flag selecting an additional mode of the analyzer
+*/
+#define MODE_FLAG_INDEX 1
 
-void addEdge(Graph *graph, int uVertexIndex, int vVertexIndex);
+/**
+* @def MODE_FIRST_ARG_INDEX 2
+* @brief Represents the index of the first argument of an additional mode
+*/
+#define MODE_FIRST_ARG_INDEX 2
 
-bool isTree(Graph *graph);
+/**
+* @def MODE_SECOND_ARG_INDEX 3
+* @brief Represents the index of the second argument of an additional mode
+*/
+#define MODE_SECOND_ARG_INDEX 3
 
-bool isConnected(Graph *graph);
+/**
+* @def MODE_FLAG_PREFIX "--"
+* @brief  a first argument starting with this prefix selects an additional mode of the analyzer
+*/
+#define MODE_FLAG_PREFIX "--"
 
-void bfs(Graph *graph, int startVertexKey, DistanceFromNode distFromVertex);
+/**
+* @def QUERY_USAGE_MSG "Usage: TreeAnalyzer --query <Graph File Path> <Queries File Path>\n"
+* @brief Error message printed when the query mode is not given the expected parameters
+*/
+#define QUERY_USAGE_MSG "Usage: TreeAnalyzer --query <Graph File Path> <Queries File Path>\n"
 
-Graph *initGraph(int verticesCount);
+/**
+* @def BUILD_INDEX_USAGE_MSG "Usage: TreeAnalyzer --build-index <Graph File Path> <Index File Path>\n"
+* @brief Error message printed when the index building mode is not given the expected parameters
+*/
+#define BUILD_INDEX_USAGE_MSG "Usage: TreeAnalyzer --build-index <Graph File Path> <Index File Path>\n"
 
-Vertex *createVertex(int vertexKey);
+/**
+* @def QUERY_INDEX_USAGE_MSG "Usage: TreeAnalyzer --query-index <Index File Path> <Queries File Path>\n"
+* @brief Error message printed when the index query mode is not given the expected parameters
+*/
+#define QUERY_INDEX_USAGE_MSG "Usage: TreeAnalyzer --query-index <Index File Path> <Queries File Path>\n"
 
-int findGraphDiameter(Graph *graph, int rootVertex);
+/**
+* @def INVALID_INDEX_MSG "Invalid index file\n"
+* @brief  Message printed when an index file can not be written, or read back
+*/
+#define INVALID_INDEX_MSG "Invalid index file\n"
 
-int findMaxBranchLength(Graph *graph, DistanceFromNode distanceFromNode);
+/**
+* @def INDEX_MAGIC "TREEIDX"
+* @brief  the first bytes of every index file
+*/
+#define INDEX_MAGIC "TREEIDX"
 
-int findMinBranchLength(Graph *graph, DistanceFromNode distanceFromNode, int root);
+/**
+* @def INDEX_VERSION 3
+* @brief  the version of the layout of the index files, changed whenever the layout changes
+*/
+#define INDEX_VERSION 3
 
-void printTreeDistanceInfo(Graph *graph);
+/**
+* @def INVALID_QUERY_MSG "Invalid query\n"
+* @brief  Message printed when a line in the queries file is not a valid query
+*/
+#define INVALID_QUERY_MSG "Invalid query\n"
 
-void printShortestPath(Graph *graph, int uVertexKey, int vVertexKey);
+/**
+* @def QUERY_NAME_LENGTH 32
+* @brief  the maximal length of the name of a query
+*/
+#define QUERY_NAME_LENGTH 32
 
-void printTreeInfo(Graph *graph, int uVertexKey, int vVertexKey);
+/**
+* @def QUERY_MAX_ARGS 3
+* @brief  the maximal amount of numerical arguments a query can have
+*/
+#define QUERY_MAX_ARGS 3
 
-void freeContent(char **content, int length);
+/**
+* @def CONVERT_USAGE_MSG "Usage: TreeAnalyzer --convert <Graph File Path> <Binary Graph File Path>\n"
+* @brief Message for invalid usage of the convert mode
+*/
+#define CONVERT_USAGE_MSG "Usage: TreeAnalyzer --convert <Graph File Path> <Binary Graph File Path>\n"
 
-void deleteAllEdges(Graph **graphPtr);
+/**
+* @def BINARY_WRITE_FAILED_MSG "Could not write the binary graph file\n"
+* @brief Message for a binary graph file that could not be written
+*/
+#define BINARY_WRITE_FAILED_MSG "Could not write the binary graph file\n"
 
-void freeGraph(Graph **graphPtr);
+/**
+* @def BINARY_GRAPH_MAGIC "TREEBIN"
+* @brief the first bytes of every binary graph file
+*/
+#define BINARY_GRAPH_MAGIC "TREEBIN"
 
-int nonNumerical(char *str);
+/**
+* @def BINARY_GRAPH_VERSION 1
+* @brief the version of the binary graph file format
+*/
+#define BINARY_GRAPH_VERSION 1
 
-bool containsNumber(char *str);
+/**
+* @def VARINT_PAYLOAD_BITS 7
+* @brief the amount of value bits in every byte of a varint
+*/
+#define VARINT_PAYLOAD_BITS 7
 
-int getMaxValueFromString(char *str);
+/**
+* @def VARINT_CONTINUE_BIT 0x80
+* @brief set in every byte of a varint except its last one
+*/
+#define VARINT_CONTINUE_BIT 0x80
 
-bool onlyDigitsAndSpaces(char *str);
+/**
+* @def VARINT_MAX_BYTES 5
+* @brief the maximal length of a varint, enough for 32 bit values
+*/
+#define VARINT_MAX_BYTES 5
 
-// ------------------------------ functions -----------------------------
+/**
+* @def METRICS_USAGE_MSG "Usage: TreeAnalyzer --metrics <Graph File Path>\n"
+* @brief Message for invalid usage of the metrics mode
+*/
+#define METRICS_USAGE_MSG "Usage: TreeAnalyzer --metrics <Graph File Path>\n"
 
 /**
- * @brief Analzing a txt file representng a graph.Expect 3 arguments <Graph File Path> <First Vertex> <Second Vertex>
- * @param argc
- * @param argv
- * */
-int main(int argc, char *argv[])
-{
+* @def RADIUS_MSG "Radius: "
+* @brief Message for displaying the radius of the tree
+*/
+#define RADIUS_MSG "Radius: "
 
-    // graph related information
-    Graph *graph;
-    int firstVertex, secondVertex;
-    int graphSize = 0;
+/**
+* @def CENTER_MSG "Center: "
+* @brief Message for displaying the centers of the tree
+*/
+#define CENTER_MSG "Center: "
 
-    // the output of the given file parsing
-    char **vertexAdjContent;
+/**
+* @def CENTROID_MSG "Centroid: "
+* @brief Message for displaying the centroids of the tree
+*/
+#define CENTROID_MSG "Centroid: "
 
-    // check the total amount of given arguments
-    if (argc != VALID_ARG_COUNT)
-    {
-        fprintf(stderr, "%s", INVALID_USAGE_MSG);
-        return EXIT_FAILURE;
-    }
+/**
+* @def ECCENTRICITIES_MSG "Eccentricities: "
+* @brief Message for displaying the eccentricity of every vertex
+*/
+#define ECCENTRICITIES_MSG "Eccentricities: "
 
-    // check whenver the given number represents valid integers
-    if ((nonNumerical(argv[FIRST_VERTEX_INDEX]) != 0) ||
-        (nonNumerical(argv[SECOND_VERTEX_INDEX]) != 0))
-    {
-        fprintf(stderr, "%s", INVALID_INPUT_MSG);
-        return EXIT_FAILURE;
-    }
+/**
+* @def SUBTREE_SIZES_MSG "Subtree Sizes: "
+* @brief Message for displaying the size of the subtree of every vertex
+*/
+#define SUBTREE_SIZES_MSG "Subtree Sizes: "
 
-    // save the vertex user input as integers
-    firstVertex = (int) strtod(argv[FIRST_VERTEX_INDEX], NULL);
-    secondVertex = (int) strtod(argv[SECOND_VERTEX_INDEX], NULL);
+/**
+* @def WIDTH_PER_DEPTH_MSG "Width Per Depth: "
+* @brief Message for displaying the amount of vertices in every depth
+*/
+#define WIDTH_PER_DEPTH_MSG "Width Per Depth: "
 
-    /* parse the given file .exit the program case something went wrong*/
-    if (!parseGraphFile(&vertexAdjContent, &graphSize, argv[FILE_PATH_INDEX]))
-    {
-        freeContent(vertexAdjContent, graphSize);
-        return EXIT_FAILURE;
-    }
+/**
+* @def MAX_CENTERS 2
+* @brief a tree has one or two centers, and one or two centroids. Edge weights are strictly positive, so that holds
+* for weighted trees as well
+*/
+#define MAX_CENTERS 2
 
-    // Create a graph
-    graph = initGraph(graphSize);
+/**
+* @def DYNAMIC_USAGE_MSG "Usage: TreeAnalyzer --dynamic <Graph File Path> <Operations File Path>\n"
+* @brief Message for invalid usage of the dynamic mode
+*/
+#define DYNAMIC_USAGE_MSG "Usage: TreeAnalyzer --dynamic <Graph File Path> <Operations File Path>\n"
 
-    /* check whenever the given vertex values are legal comapred to the graph size.Exit eitherwise*/
-    if (firstVertex >= graphSize || secondVertex >= graphSize)
-    {
-        fprintf(stderr, "%s", INVALID_INPUT_MSG);
-        freeContent(vertexAdjContent, graphSize);
-        freeGraph(&graph);
-        return EXIT_FAILURE;
-    }
+/**
+* @def INVALID_OPERATION_MSG "Invalid operation\n"
+* @brief Message for an invalid line in an operations file
+*/
+#define INVALID_OPERATION_MSG "Invalid operation\n"
 
-    // Attached the edges for each vertex
-    attachEdges(graph, vertexAdjContent);
+/**
+* @def DIAMETER_ENDPOINTS_MSG "Diameter Endpoints: "
+* @brief Message for displaying the endpoints of the diameter
+*/
+#define DIAMETER_ENDPOINTS_MSG "Diameter Endpoints: "
 
-    // check whenever a tree was provided
-    if (!isTree(graph))
-    {
-        fprintf(stderr, "%s", GRAPH_NOT_TREE_MSG);
-        freeContent(vertexAdjContent, graphSize);
-        freeGraph(&graph);
-        return EXIT_FAILURE;
-    }
+/**
+* @def GENERATE_USAGE_MSG
+* @brief Message for invalid usage of the generate mode
+*/
+#define GENERATE_USAGE_MSG "Usage: TreeAnalyzer --generate <Tree Kind> <Vertices Count> <Graph File Path>\n" \
+                           "Tree kinds: path, star, kary-<k>, prufer, caterpillar, near-tree\n"
 
-    // set the root of the tree
-    setRootVertexKey(graph);
-    printTreeInfo(graph, firstVertex, secondVertex);
+/**
+* @def BENCHMARK_USAGE_MSG
+* @brief Message for invalid usage of the benchmark mode
+*/
+#define BENCHMARK_USAGE_MSG "Usage: TreeAnalyzer --benchmark <Tree Kind> <Max Vertices Count> <Graph File Path>\n" \
+                            "Tree kinds: path, star, kary-<k>, prufer, caterpillar, near-tree\n" \
+                            "The max vertices count is at least 1000\n"
 
-    // delete the graph
-    freeGraph(&graph);
+/**
+* @def GENERATOR_SEED 0x9E3779B97F4A7C15
+* @brief the seed of the random generator, so generated trees are reproducible
+*/
+#define GENERATOR_SEED 0x9E3779B97F4A7C15ULL
 
-    // delete the text file data
-    freeContent(vertexAdjContent, graphSize);
+/**
+* @def KARY_PREFIX "kary-"
+* @brief the prefix of the kind of complete k-ary trees, followed by k
+*/
+#define KARY_PREFIX "kary-"
 
-    return EXIT_SUCCESS;
+/**
+* @def MAX_VERTEX_DIGITS 11
+* @brief the maximal length of a vertex in a row, including the separating space
+*/
+#define MAX_VERTEX_DIGITS 11
 
-}
+/**
+* @def RESERVED_ROW_VERTICES 2
+* @brief the amount of vertices kept free in every generated row, for the parent and for an extra edge
+*/
+#define RESERVED_ROW_VERTICES 2
 
 /**
- * @brief Checks whenever the a line in the text file representing a vertex edge relation is valid
- * @param str
- * */
-int validateVertexAmountLine(char *str)
-{
-    char *nextNumber = str;
+* @def BENCHMARK_MIN_VERTICES 1000
+* @brief the size of the smallest benchmarked tree. Every next size is 10 times larger
+*/
+#define BENCHMARK_MIN_VERTICES 1000
 
-    // should contain number
-    if (!containsNumber(str))
-    {
-        return false;
-    }
+/**
+* @def BENCHMARK_SIZE_FACTOR 10
+* @brief the ratio between the sizes of consecutive benchmarked trees
+*/
+#define BENCHMARK_SIZE_FACTOR 10
 
+/**
+* @def BENCHMARK_QUERIES_COUNT 1000
+* @brief the amount of random path queries timed for every benchmarked tree
+*/
+#define BENCHMARK_QUERIES_COUNT 1000
 
-    strtol(nextNumber, &nextNumber, 10);
+/**
+* @def BENCHMARK_HEADER
+* @brief the first line of the benchmark output, naming the comma separated columns. Times are in seconds
+*/
+#define BENCHMARK_HEADER "kind,vertices,parse,build,is_tree,distances,index,queries,result\n"
 
-    // should only contain a single number
-    if (strlen(nextNumber) != 0)
-    {
-        return false;
-    }
+/**
+* @def DIAGNOSTICS_ENV_VAR "TREE_ANALYZER_DIAGNOSTICS"
+* @brief the environment variable enabling diagnostics. Set to "stderr" or to the path of a json file
+*/
+#define DIAGNOSTICS_ENV_VAR "TREE_ANALYZER_DIAGNOSTICS"
 
-    return true;
-}
+/**
+* @def DIAGNOSTICS_TO_STDERR "stderr"
+* @brief the value of the diagnostics environment variable printing the diagnostics to stderr
+*/
+#define DIAGNOSTICS_TO_STDERR "stderr"
 
 /**
- * @brief Checks whenver the first line representing graph size in the supplied text file is valid
- * @param numOfVertices
- * @param line
- * @param rowIndex
- * */
-bool validateVertexEdgeLine(char *line, int rowIndex, int numOfVertices)
-{
+* @def MAX_DIAGNOSTICS_PHASES 16
+* @brief the maximal amount of timed phases in a single run
+*/
+#define MAX_DIAGNOSTICS_PHASES 16
 
-    if (rowIndex >= numOfVertices)
-    {
-        fprintf(stderr, "%s", INVALID_INPUT_MSG);
+/**
+* @def DIAGNOSTICS_WRITE_FAILED_MSG "Could not write the diagnostics file\n"
+* @brief Message for a diagnostics file that could not be written
+*/
+#define DIAGNOSTICS_WRITE_FAILED_MSG "Could not write the diagnostics file\n"
 
-        return false;
-    }
+/**
+* @def PATH_LENGTH_MSG "Length of Shortest Path: "
+* @brief Message for displaying the weighted length of the path between the given vertices
+*/
+#define PATH_LENGTH_MSG "Length of Shortest Path: "
 
-    if ((!onlyDigitsAndSpaces(line)) && (strcmp(IS_LEAF, line) != 0))
-    {
-        fprintf(stderr, "%s", INVALID_INPUT_MSG);
-        return false;
-    }
+/**
+* @def WEIGHTED_CONVERT_MSG "Weighted graphs can not be converted to the binary format\n"
+* @brief Message for converting a weighted graph, as the binary format has no edge weights
+*/
+#define WEIGHTED_CONVERT_MSG "Weighted graphs can not be converted to the binary format\n"
 
-    if (numOfVertices <= getMaxValueFromString(line))
-    {
-        fprintf(stderr, "%s", INVALID_INPUT_MSG);
-        return false;
-    }
+/**
+* @def EXPORT_PRUFER_USAGE_MSG "Usage: TreeAnalyzer --export-prufer <Graph File Path> <Prufer File Path>\n"
+* @brief Message for invalid usage of the prufer export mode
+*/
+#define EXPORT_PRUFER_USAGE_MSG "Usage: TreeAnalyzer --export-prufer <Graph File Path> <Prufer File Path>\n"
 
-    return true;
-}
+/**
+* @def WEIGHTED_PRUFER_MSG "Weighted graphs can not be exported as prufer sequences\n"
+* @brief Message for exporting a weighted graph, as a prufer sequence has no edge weights
+*/
+#define WEIGHTED_PRUFER_MSG "Weighted graphs can not be exported as prufer sequences\n"
 
+/**
+* @def PRUFER_WRITE_FAILED_MSG "Could not write the prufer file\n"
+* @brief Message for a prufer file that could not be written
+*/
+#define PRUFER_WRITE_FAILED_MSG "Could not write the prufer file\n"
 
 /**
- * @brief Parses a txt file representing a graph in the given foramt that was provided as input ar
- * @param graph
- * @param numOfVertices
- * @param file
- * */
-bool parseGraphFile(char ***vertexAdjContent, int *numOfVertices, char *file)
-{
-    FILE *fp;
-    char line[MAX_ROW_LENGTH + 1];
-    int rowIndex = 0;
+* @def PRUFER_MAGIC "prufer"
+* @brief the first line of every prufer file, followed by the amount of vertices and the n-2 vertices of the sequence
+*/
+#define PRUFER_MAGIC "prufer"
 
-    fp = fopen(file, "r");
-    if (fp == NULL)
-    {
+/**
+* @def PRUFER_SEPARATORS " \r\n"
+* @brief the characters separating the numbers of a prufer file
+*/
+#define PRUFER_SEPARATORS " \r\n"
+
+/**
+* @def FOREST_USAGE_MSG "Usage: TreeAnalyzer --forest <Graph File Path>\n"
+* @brief Message for invalid usage of the forest mode
+*/
+#define FOREST_USAGE_MSG "Usage: TreeAnalyzer --forest <Graph File Path>\n"
+
+/**
+* @def GRAPH_NOT_FOREST_MSG "The given graph is not a forest\n"
+* @brief Error message printed when the graph given to the forest mode has a cycle
+*/
+#define GRAPH_NOT_FOREST_MSG "The given graph is not a forest\n"
+
+/**
+* @def COMPONENTS_COUNT_MSG "Components Count: "
+* @brief Message for displaying the amount of connected components of a forest
+*/
+#define COMPONENTS_COUNT_MSG "Components Count: "
+
+/**
+* @def COMPONENT_MSG "Component "
+* @brief Message starting the analysis of a single component of a forest, followed by its place by size
+*/
+#define COMPONENT_MSG "Component "
+
+/**
+* @def BATCH_USAGE_MSG "Usage: TreeAnalyzer --batch <Manifest File Path>\n"
+* @brief Message for invalid usage of the batch mode
+*/
+#define BATCH_USAGE_MSG "Usage: TreeAnalyzer --batch <Manifest File Path>\n"
+
+/**
+* @def BATCH_FIRST_JOBS_CAPACITY 16
+* @brief the amount of jobs allocated for the first lines of a manifest. It is doubled whenever it is exceeded
+*/
+#define BATCH_FIRST_JOBS_CAPACITY 16
+
+/**
+* @def MANIFEST_SEPARATORS " \t"
+* @brief the characters separating the fields of a line in a manifest
+*/
+#define MANIFEST_SEPARATORS " \t"
+
+/**
+* @def ROW_TERMINATORS "\r\n"
+* @brief the characters ending a row of a graph file
+*/
+#define ROW_TERMINATORS "\r\n"
+
+/**
+* @def MIN_ROW_BYTES 2
+* @brief the least amount of bytes a row of a graph file takes, as "-" and its terminator. The last row may have no
+* terminator
+*/
+#define MIN_ROW_BYTES 2
+
+/**
+* @def MAX_PARSED_DIGITS 19
+* @brief the maximal amount of digits of a number in a row which is parsed without overflowing 64 bits
+*/
+#define MAX_PARSED_DIGITS 19
+
+/**
+* @def SWAR_WORD_LENGTH 8
+* @brief the amount of characters of a row which are parsed together, as a single 64 bit word
+*/
+#define SWAR_WORD_LENGTH 8
+
+/**
+* @def SWAR_ZERO_DIGITS 0x3030303030303030ULL
+* @brief a word of '0' characters. Subtracting it from a word of digits leaves the value of every digit in its byte
+*/
+#define SWAR_ZERO_DIGITS 0x3030303030303030ULL
+
+/**
+* @def SWAR_DIGIT_LIMIT 0x7676767676767676ULL
+* @brief added to the bytes of a word after SWAR_ZERO_DIGITS was subtracted, it sets the high bit of every byte
+* above 9
+*/
+#define SWAR_DIGIT_LIMIT 0x7676767676767676ULL
+
+/**
+* @def SWAR_HIGH_BITS 0x8080808080808080ULL
+* @brief the high bit of every byte of a word
+*/
+#define SWAR_HIGH_BITS 0x8080808080808080ULL
+
+/**
+* @def SWAR_PAIRS_MASK 0x00FF00FF00FF00FFULL
+* @brief the bytes of a word holding the values of pairs of digits
+*/
+#define SWAR_PAIRS_MASK 0x00FF00FF00FF00FFULL
+
+/**
+* @def SWAR_QUADS_MASK 0x0000FFFF0000FFFFULL
+* @brief the 16 bit parts of a word holding the values of quads of digits
+*/
+#define SWAR_QUADS_MASK 0x0000FFFF0000FFFFULL
+
+/**
+* @def SWAR_OCTET_MASK 0x00000000FFFFFFFFULL
+* @brief the 32 bit part of a word holding the value of all of its eight digits
+*/
+#define SWAR_OCTET_MASK 0x00000000FFFFFFFFULL
+
+/**
+* @def SERVE_USAGE_MSG "Usage: TreeAnalyzer --serve <Socket Path | -> <Trees File Path>\n"
+* @brief Message for invalid usage of the serve mode
+*/
+#define SERVE_USAGE_MSG "Usage: TreeAnalyzer --serve <Socket Path | -> <Trees File Path>\n"
+
+/**
+* @def SERVE_STDIO "-"
+* @brief given instead of a socket path to answer the queries of stdin on stdout
+*/
+#define SERVE_STDIO "-"
+
+/**
+* @def SERVER_SOCKET_FAILED_MSG "Could not listen on the socket\n"
+* @brief Message printed when the socket of the server can not be created
+*/
+#define SERVER_SOCKET_FAILED_MSG "Could not listen on the socket\n"
+
+/**
+* @def SERVER_OK_MSG "OK\n"
+* @brief the line ending the answer of every valid request to the server
+*/
+#define SERVER_OK_MSG "OK\n"
+
+/**
+* @def SERVER_TREE_COMMAND "tree"
+* @brief the request selecting the tree, by its place in the trees file, which the later queries are answered on
+*/
+#define SERVER_TREE_COMMAND "tree"
+
+/**
+* @def SERVER_SHUTDOWN_COMMAND "shutdown"
+* @brief the request stopping the server
+*/
+#define SERVER_SHUTDOWN_COMMAND "shutdown"
+
+/**
+* @def SERVER_FIRST_TREES_CAPACITY 4
+* @brief the amount of trees allocated for the first lines of a trees file. It is doubled whenever it is exceeded
+*/
+#define SERVER_FIRST_TREES_CAPACITY 4
+
+/**
+* @def ISOMORPHISM_USAGE_MSG "Usage: TreeAnalyzer --isomorphism <Manifest File Path>\n"
+* @brief Message for invalid usage of the isomorphism mode
+*/
+#define ISOMORPHISM_USAGE_MSG "Usage: TreeAnalyzer --isomorphism <Manifest File Path>\n"
+
+/**
+* @def ROOTED_ISOMORPHISM_USAGE_MSG "Usage: TreeAnalyzer --rooted-isomorphism <Manifest File Path>\n"
+* @brief Message for invalid usage of the rooted isomorphism mode
+*/
+#define ROOTED_ISOMORPHISM_USAGE_MSG "Usage: TreeAnalyzer --rooted-isomorphism <Manifest File Path>\n"
+
+/**
+* @def CANONICAL_HASH_OFFSET 14695981039346656037ULL
+* @brief the starting value of the FNV-1a hash of a canonical encoding
+*/
+#define CANONICAL_HASH_OFFSET 14695981039346656037ULL
+
+/**
+* @def CANONICAL_HASH_PRIME 1099511628211ULL
+* @brief the multiplier of the FNV-1a hash of a canonical encoding
+*/
+#define CANONICAL_HASH_PRIME 1099511628211ULL
+
+/**
+* @def GRAPH_USAGE_MSG "Usage: TreeAnalyzer --graph <Graph File Path> <First Vertex> <Second Vertex>\n"
+* @brief Message for invalid usage of the general graph mode
+*/
+#define GRAPH_USAGE_MSG "Usage: TreeAnalyzer --graph <Graph File Path> <First Vertex> <Second Vertex>\n"
+
+/**
+* @def ECCENTRICITIES_USAGE_MSG "Usage: TreeAnalyzer --eccentricities <Graph File Path>\n"
+* @brief Message for invalid usage of the eccentricities mode
+*/
+#define ECCENTRICITIES_USAGE_MSG "Usage: TreeAnalyzer --eccentricities <Graph File Path>\n"
+
+/**
+* @def WEIGHTED_GRAPH_MSG "Weighted graphs are only analyzed when they are trees\n"
+* @brief Message for a weighted graph which is not a tree, as the distances of general graphs are counted in edges
+*/
+#define WEIGHTED_GRAPH_MSG "Weighted graphs are only analyzed when they are trees\n"
+
+/**
+* @def NO_PATH_MSG " No Path"
+* @brief Message printed instead of the path between two vertices in different components
+*/
+#define NO_PATH_MSG " No Path"
+
+/**
+* @def RADIUS_MSG "Radius: "
+* @brief Message for displaying the smallest eccentricity of a graph
+*/
+#define RADIUS_MSG "Radius: "
+
+/**
+* @def ECCENTRICITY_MSG "Eccentricity of "
+* @brief Message for displaying the eccentricity of a vertex
+*/
+#define ECCENTRICITY_MSG "Eccentricity of "
+
+/**
+* @def BIT_PARALLEL_SOURCES 64
+* @brief the amount of sources a bit parallel bfs traverses from at once, a bit of a word for every source
+*/
+#define BIT_PARALLEL_SOURCES 64
+
+
+// ------------------------------ Structures -----------------------------
+
+/**
+ * @brief represents A vertex
+ * */
+typedef struct Vertex
+{
+    struct Vertex *next; /* representing all the connected with distance of 1 vertexs*/
+    int vertexKey; /* the numerical id of the vertex **/
+    int weight; /* the weight of the edge to the vertex **/
+
+} Vertex;
+
+/**
+ * @brief represents a block of memory of an arena
+ **/
+typedef struct ArenaBlock
+{
+    struct ArenaBlock *next; /** the block allocated before this one**/
+    size_t used; /** the amount of bytes already handed out from the block**/
+    size_t capacity; /** the amount of bytes in the block**/
+    char *data; /** the memory of the block, allocated together with the block header**/
+} ArenaBlock;
+
+/**
+ * @brief represents an arena: many small allocations are served from a few large blocks, which are all released
+ * together. There is no way to release a single allocation
+ **/
+typedef struct Arena
+{
+    ArenaBlock *head; /** the block allocations are currently served from**/
+    size_t nextBlockSize; /** the size of the next block to allocate**/
+    size_t allocatedBytes; /** the total amount of bytes handed out from the arena**/
+} Arena;
+
+/**
+ * @brief represents a graph
+ **/
+typedef struct Graph
+{
+    Vertex **listOfAdjacent; /** represents infomration of adjecnt connected vertex for each vertex in the graph**/
+    Vertex **listOfAncestors; /** represents  for every vertex from which other vertex they were attached**/
+    int verticesCount; /** represents the total amount of vertices in the graph **/
+    int edgesCount; /** represents the total edge count**/
+    int root; /** represents the index of the root**/
+    bool weighted; /** whenever any edge was given a weight, so lengths are sums of weights and not edge counts**/
+    int *originalKeys; /** the key every vertex had in the input when the graph was relabeled, NULL otherwise**/
+    Arena arena; /** the memory of all the vertices in the adjacency lists**/
+} Graph;
+
+/**
+ * @brief represents a partition of the vertices into disjoint sets (union-find).
+ * Used to reject an input as soon as one of its edges closes a cycle
+ **/
+typedef struct DisjointSets
+{
+    int *parent; /** the parent of every vertex in the tree of its set, the root of the tree represents the set**/
+    int *size; /** the size of every set, valid for the representatives only**/
+} DisjointSets;
+
+/**
+ * @brief represents the rows of a text graph file, parsed to the neighbors listed in every row.
+ * A run of spaces ending a row was always read as edges to vertex 0, one for every space after the first, or for
+ * every space of a row without neighbors. Those stray edges are kept as neighbors 0 at the end of their row, so they
+ * are checked as edges of a tree like any other neighbor. A file with stray edges is still a tree when they join it
+ * without a cycle and the file has n-1 edges in total
+ **/
+typedef struct GraphRows
+{
+    int verticesCount; /** the amount of rows the first line of the file asks for**/
+    int *offsets; /** the neighbors of row v are at [offsets[v], offsets[v + 1]) of the neighbors**/
+    int *neighbors; /** the neighbors of all the rows, row after row**/
+    int *weights; /** the weight of the edge to every neighbor, NULL when no edge in the file has a weight**/
+    int edgesCount; /** the amount of neighbors of all the rows**/
+    int capacity; /** the amount of neighbors the arrays can hold**/
+} GraphRows;
+
+/**
+ * @brief an array represents for a given vertex v the distance to every other vertex in a given graph.
+ * Each index in the array represnts the index of the vertex.
+ **/
+typedef int *DistanceFromNode;
+
+/**
+ * @brief a function running a share of a parallel task, given the index of the thread and the amount of threads
+ **/
+typedef void (*ParallelTask)(void *taskArgs, int threadIndex, int threadCount);
+
+struct ThreadPool;
+
+/**
+ * @brief represents the arguments of a worker thread in a thread pool
+ **/
+typedef struct WorkerArgs
+{
+    struct ThreadPool *pool; /** the pool the worker belongs to**/
+    int threadIndex; /** the index of the worker, passed to the tasks it runs**/
+} WorkerArgs;
+
+/**
+ * @brief represents a pool of threads which all run the same task, each on its share of the work.
+ * The thread running the task is one of the workers, so a pool of a single thread creates no threads
+ **/
+typedef struct ThreadPool
+{
+    pthread_t *threads; /** the worker threads, the first one is the calling thread and is never created**/
+    WorkerArgs *workers; /** the arguments of every worker thread**/
+    int threadCount; /** the total amount of workers, including the calling thread**/
+    pthread_mutex_t lock; /** guards every field below**/
+    pthread_cond_t taskReady; /** signaled when a task is given or the pool is stopped**/
+    pthread_cond_t taskDone; /** signaled when the last worker finishes a task**/
+    ParallelTask task; /** the current task**/
+    void *taskArgs; /** the arguments of the current task**/
+    unsigned long generation; /** incremented for every task, so workers tell a new task from the last one**/
+    int runningWorkers; /** the amount of workers still running the current task**/
+    bool stopping; /** set when the workers should exit**/
+} ThreadPool;
+
+/**
+ * @brief represents the state of a direction optimizing bfs running on a thread pool.
+ * The adjacency lists are copied into contiguous arrays, and the visited vertices and frontiers are bitmaps
+ **/
+typedef struct ParallelBfs
+{
+    ThreadPool *pool; /** the threads running the traversal**/
+    int verticesCount; /** the total amount of vertices in the graph**/
+    long wordsCount; /** the amount of words in each bitmap**/
+    int *adjacencyOffsets; /** the neighbors of vertex v are adjacency[adjacencyOffsets[v]..adjacencyOffsets[v+1])**/
+    int *adjacency; /** the neighbors of all the vertices, stored contiguously**/
+    uint64_t *visited; /** bitmap of the vertices reached so far**/
+    uint64_t *frontier; /** bitmap of the current frontier, kept while stepping bottom up**/
+    uint64_t *nextFrontier; /** bitmap of the next frontier, filled while stepping bottom up**/
+    int *queue; /** the current frontier**/
+    int *nextQueue; /** the next frontier**/
+    int queueSize; /** the size of the current frontier**/
+    int nextQueueSize; /** the size of the next frontier, incremented atomically**/
+    long frontierEdges; /** the amount of edges leaving the current frontier**/
+    long *threadEdges; /** the amount of edges leaving the vertices each thread added to the next frontier**/
+    int level; /** the distance of the current frontier from the start vertex**/
+    DistanceFromNode dist; /** the distances filled by the current traversal**/
+    int *traverseSource; /** the traversal sources filled by the current traversal**/
+} ParallelBfs;
+
+/**
+ * @brief represents the buffers of bfs, allocated once and reused by every traversal of a graph.
+ * A vertex is visited when its stamp equals the generation of the current traversal, so starting a traversal
+ * only increments the generation instead of clearing the stamps
+ **/
+typedef struct BfsWorkspace
+{
+    int capacity; /** the amount of vertices in the traversed graph**/
+    int *queue; /** ring buffer holding the vertices waiting to be expanded**/
+    unsigned int *visitedGeneration; /** the generation of the last traversal which visited every vertex**/
+    unsigned int generation; /** the generation of the current traversal**/
+    DistanceFromNode dist; /** the distances of traversals whose caller does not keep them**/
+    int *parent; /** the traversal sources of traversals whose caller does not keep them**/
+} BfsWorkspace;
+
+/**
+ * @brief represents the wall time of a single phase of a run
+ **/
+typedef struct DiagnosticsPhase
+{
+    char *name; /** the name of the function performing the phase**/
+    double seconds; /** the wall time of the phase**/
+} DiagnosticsPhase;
+
+/**
+ * @brief represents the measurements of a run, collected when diagnostics are enabled
+ **/
+typedef struct Diagnostics
+{
+    char *output; /** DIAGNOSTICS_TO_STDERR, or the path of the json file to write**/
+    DiagnosticsPhase phases[MAX_DIAGNOSTICS_PHASES]; /** the timed phases, in the order they ended**/
+    int phasesCount; /** the amount of timed phases**/
+    int bfsPasses; /** the amount of traversals of the graph**/
+    size_t vertexBytes; /** the bytes allocated by createVertex**/
+    size_t lineBytes; /** the bytes allocated for the parsed rows of the graph file**/
+} Diagnostics;
+
+/**
+ * @brief represents the buffers shared by every traversal of a single tree analysis, and its results.
+ * The buffers are allocated once so the analysis performs the minimal amount of traversals and allocations.
+ **/
+typedef struct TreeAnalysis
+{
+    DistanceFromNode distFromRoot; /** the distance of every vertex from the root of the tree**/
+    int *parent; /** the vertex from which every vertex was reached when traversing from the root**/
+    int *scratch; /** used to reverse the second half of a path while printing it**/
+    BfsWorkspace *workspace; /** the buffers of every bfs of the analysis**/
+    long long *weightedDepth; /** the sum of the weights from the root to every vertex, NULL until a weighted tree**/
+    int farthestFromRoot; /** a vertex with a maximal distance from the root**/
+    long long minBranchLength; /** the length of the minimal branch of the tree**/
+    long long maxBranchLength; /** the length of the maximal branch of the tree**/
+    long long diameter; /** the length of the diameter of the tree**/
+    ParallelBfs *parallelBfs; /** used for traversing large graphs, NULL until the first such traversal**/
+    int threadCount; /** the amount of threads traversing large graphs, 0 until the first such traversal**/
+    Diagnostics *diagnostics; /** the measurements of the run, NULL when diagnostics are disabled**/
+} TreeAnalysis;
+
+/**
+ * @brief represents a rooted tree preprocessed for answering queries without traversing it.
+ * The lowest common ancestor of two vertices is the shallowest vertex visited between their first visits in the
+ * euler tour of the tree, so it is found in O(1) using a sparse table of range minimums over the tour.
+ **/
+typedef struct TreeIndex
+{
+    int verticesCount; /** the total amount of vertices in the tree**/
+    int root; /** the root of the tree**/
+    int *parent; /** the parent of every vertex, -1 for the root**/
+    int *depth; /** the distance of every vertex from the root**/
+    long long *weightedDepth; /** the sum of the weights from the root to every vertex, NULL for unweighted trees**/
+    int *eulerTour; /** the vertices in the order a dfs from the root enters and returns to them**/
+    int *firstVisit; /** the index of the first appearance of every vertex in the euler tour**/
+    int *entryTime; /** the index of every vertex in the order a dfs from the root enters the vertices**/
+    int *exitTime; /** the largest entry time in the subtree of every vertex**/
+    int *sparseTable; /** for every level k, the shallowest vertex in each range of length 2^k of the tour**/
+    int tourLength; /** the length of the euler tour, 2n-1**/
+    int levels; /** the amount of levels in the sparse table**/
+    int *adjacencyOffsets; /** the neighbors of vertex v are adjacency[adjacencyOffsets[v]..adjacencyOffsets[v+1])**/
+    int *adjacency; /** the neighbors of all the vertices, stored contiguously**/
+    int edgesCount; /** the total edge count**/
+    long long minBranchLength; /** the length of the minimal branch of the tree**/
+    long long maxBranchLength; /** the length of the maximal branch of the tree**/
+    long long diameter; /** the length of the diameter of the tree**/
+    void *mapping; /** the mapped index file holding the arrays, NULL when they were allocated**/
+    size_t mappingSize; /** the size of the mapped index file**/
+} TreeIndex;
+
+/**
+ * @brief represents the header of an index file. It is followed by the arrays of the index in the order:
+ * weightedDepth (only for weighted trees, first so it stays aligned), parent, depth, adjacencyOffsets, adjacency,
+ * firstVisit, eulerTour, sparseTable, entryTime and exitTime
+ **/
+typedef struct IndexHeader
+{
+    char magic[8]; /** INDEX_MAGIC**/
+    int version; /** INDEX_VERSION**/
+    int verticesCount; /** the total amount of vertices in the tree**/
+    int root; /** the root of the tree**/
+    int edgesCount; /** the total edge count**/
+    int weighted; /** 1 when the tree is weighted, 0 otherwise**/
+    int tourLength; /** the length of the euler tour**/
+    int levels; /** the amount of levels in the sparse table**/
+    long long minBranchLength; /** the length of the minimal branch of the tree**/
+    long long maxBranchLength; /** the length of the maximal branch of the tree**/
+    long long diameter; /** the length of the diameter of the tree**/
+} IndexHeader;
+
+/**
+ * @brief represents the weights of the vertices of a tree, over a heavy-light decomposition of the tree. The
+ * vertices are placed in a preorder in which every vertex is directly followed by its heavy child, the child with the
+ * largest subtree, so every heavy path and every subtree is a range of places. A path between two vertices crosses
+ * O(log n) heavy paths, and every range is updated or summed in O(log n) by a segment tree
+ **/
+typedef struct PathDecomposition
+{
+    int verticesCount; /** the amount of vertices of the tree**/
+    int *position; /** the place of every vertex in the preorder**/
+    int *head; /** the highest vertex of the heavy path of every vertex**/
+    int leavesCount; /** the amount of leaves of the segment tree, the smallest power of 2 not below the vertices**/
+    long long *sums; /** the total weight of the range of every node of the segment tree, the root is node 1**/
+    long long *maxima; /** the largest weight in the range of every node**/
+    long long *pending; /** the weight added to every vertex in the range of a node and not yet to its children**/
+} PathDecomposition;
+
+/**
+ * @brief represents the state needed for answering queries on a tree
+ **/
+typedef struct QueryEngine
+{
+    TreeIndex *index; /** the preprocessed tree**/
+    int *scratch; /** used to reverse the second half of a path while printing it**/
+    PathDecomposition *paths; /** the weights of the vertices, NULL until the first weight is added**/
+} QueryEngine;
+
+/**
+ * @brief a function answering a single query with the given arguments. Returns false when the query is invalid
+ **/
+typedef bool (*QueryFunc)(QueryEngine *engine, long *args, FILE *out);
+
+/**
+ * @brief represents a query that can appear in a queries file
+ **/
+typedef struct TreeQuery
+{
+    const char *name; /** the name the query is invoked by**/
+    int argCount; /** the amount of numerical arguments of the query**/
+    int vertexArgCount; /** the amount of leading arguments that must be vertices of the tree**/
+    QueryFunc run; /** answers the query**/
+} TreeQuery;
+
+/**
+ * @brief a function running an additional mode of the analyzer with the program arguments. Returns the exit code
+ **/
+typedef int (*ModeFunc)(char *argv[]);
+
+/**
+ * @brief represents an additional mode of the analyzer, selected by a flag given as the first argument
+ **/
+typedef struct AnalyzerMode
+{
+    const char *flag; /** the flag selecting the mode**/
+    int argCount; /** the amount of expected arguments, including the program name and the flag**/
+    const char *usage; /** printed when the mode is given unexpected arguments**/
+    ModeFunc run; /** runs the mode**/
+} AnalyzerMode;
+
+/**
+ * @brief represents the header of a binary graph file. It is followed by a row for every vertex, in order. A row
+ * is a varint holding the amount of neighbors of the vertex, followed by a varint for every neighbor. A neighbor is
+ * stored as the zigzag encoded difference from the previous neighbor of the row, or from the vertex itself for the
+ * first neighbor, so the rows of sorted and local trees take a byte per neighbor
+ **/
+typedef struct BinaryGraphHeader
+{
+    char magic[8]; /** BINARY_GRAPH_MAGIC**/
+    int version; /** BINARY_GRAPH_VERSION**/
+    int verticesCount; /** the total amount of vertices in the graph**/
+} BinaryGraphHeader;
+
+/**
+ * @brief represents the metrics of a tree that depend on every vertex, rooted at the root of the tree
+ **/
+typedef struct TreeMetrics
+{
+    int verticesCount; /** the total amount of vertices in the tree**/
+    long long *eccentricity; /** the length of the path from every vertex to the farthest vertex from it**/
+    int *subtreeSize; /** the amount of vertices in the subtree of every vertex**/
+    int *widthPerDepth; /** the amount of vertices in every depth**/
+    int depthsCount; /** the amount of depths in the tree**/
+    long long radius; /** the minimal eccentricity**/
+    int centers[MAX_CENTERS]; /** the vertices whose eccentricity is the radius**/
+    int centersCount; /** the amount of centers**/
+    int centroids[MAX_CENTERS]; /** the vertices whose removal leaves no part larger than half the tree**/
+    int centroidsCount; /** the amount of centroids**/
+} TreeMetrics;
+
+/**
+ * @brief represents a rooted tree which grows by operations, with the metrics that are kept up to date.
+ * Every vertex keeps a jump pointer to one of its ancestors, chosen by its depth only, so an ancestor at any depth,
+ * and the lowest common ancestor of two vertices, are found in O(log n) while a vertex is added in O(1)
+ **/
+typedef struct DynamicTree
+{
+    int verticesCount; /** the total amount of vertices in the tree**/
+    int capacity; /** the amount of vertices the arrays can hold**/
+    int root; /** the root of the tree**/
+    int *parent; /** the parent of every vertex, -1 for the root**/
+    int *depth; /** the distance of every vertex from the root, -1 while a vertex is being attached**/
+    int *jump; /** an ancestor of every vertex, the root for the root**/
+    int maxBranchLength; /** the length of the maximal branch of the tree**/
+    int diameterEnds[2]; /** the endpoints of a longest path in the tree**/
+    int diameter; /** the length of the diameter of the tree**/
+} DynamicTree;
+
+/**
+ * @brief a function performing a single operation on a dynamic tree, given the arguments text after the operation
+ * name. Returns false when the operation is invalid
+ **/
+typedef bool (*DynamicOperationFunc)(DynamicTree *tree, char *args, FILE *out);
+
+/**
+ * @brief represents an operation that can appear in an operations file
+ **/
+typedef struct DynamicOperation
+{
+    char *name; /** the name of the operation, the first word of its line**/
+    DynamicOperationFunc run; /** performs the operation**/
+} DynamicOperation;
+
+/**
+ * @brief a function filling the parent of every vertex of a generated tree, -1 for the root
+ **/
+typedef void (*TreeGeneratorFunc)(int *parent, int verticesCount, int arity, uint64_t *randomState);
+
+/**
+ * @brief represents a kind of tree that can be generated
+ **/
+typedef struct TreeGenerator
+{
+    char *name; /** the name of the kind, or its prefix when it takes an arity**/
+    bool takesArity; /** whenever the name is followed by the amount of children of every vertex**/
+    bool addsExtraEdge; /** whenever an edge closing a cycle is added, so the graph is not a tree**/
+    TreeGeneratorFunc generate; /** fills the parents of the tree**/
+} TreeGenerator;
+
+/**
+ * @brief represents a single analysis of a batch, read from a line of the manifest
+ **/
+typedef struct BatchJob
+{
+    char *file; /** the path of the graph file**/
+    int uVertexKey; /** the path start vertex**/
+    int vVertexKey; /** the path end vertex**/
+    bool valid; /** whenever the line of the job holds a file and two valid vertices**/
+    char *result; /** the json line of the result, written by the worker running the job**/
+    size_t resultSize; /** the length of the result**/
+    bool succeeded; /** whenever the analysis of the job succeeded**/
+} BatchJob;
+
+/**
+ * @brief represents the buffers of a thread running batch jobs. They are reused by every job of the thread, and
+ * only grow when a larger graph is analyzed
+ **/
+typedef struct BatchWorker
+{
+    TreeAnalysis *analysis; /** the analysis buffers, NULL until the first job of the thread**/
+    int capacity; /** the amount of vertices the analysis buffers can hold**/
+} BatchWorker;
+
+/**
+ * @brief represents the jobs of a batch, shared by all of its threads
+ **/
+typedef struct Batch
+{
+    BatchJob *jobs; /** the jobs, in the order of the manifest**/
+    int jobsCount; /** the total amount of jobs**/
+    int nextJob; /** the first job no thread took yet. Taken atomically**/
+    BatchWorker *workers; /** the buffers of every thread**/
+} Batch;
+
+/**
+ * @brief represents a connected component of a forest, which is a tree, and its analysis
+ **/
+typedef struct ForestComponent
+{
+    int root; /** a leaf of the component until it is analyzed, then the root of the component as a tree**/
+    int verticesCount; /** the amount of vertices in the component**/
+    int offset; /** the first index of the component in the traversal order buffer of the forest**/
+    long long minBranchLength; /** the length of the minimal branch of the component**/
+    long long maxBranchLength; /** the length of the maximal branch of the component**/
+    long long diameter; /** the length of the diameter of the component**/
+} ForestComponent;
+
+/**
+ * @brief represents a forest whose components are analyzed in parallel. The components are disjoint, so the
+ * buffers indexed by vertex are shared by all the threads
+ **/
+typedef struct Forest
+{
+    Graph *graph; /** the graph of the forest**/
+    DisjointSets *sets; /** the components, merged concurrently. Every vertex is linked to its representative once
+                         * all the edges were added**/
+    bool cycleFound; /** whenever an edge closed a cycle, so the graph is not a forest. Set atomically**/
+    ForestComponent *components; /** the components, from the largest to the smallest**/
+    int componentsCount; /** the amount of components**/
+    int nextComponent; /** the first component no thread took yet. Taken atomically**/
+    long long *length; /** the distance of every vertex from the start of the last traversal of its component**/
+    int *order; /** the vertices of every component in the order of its last traversal, from its offset**/
+} Forest;
+
+/**
+ * @brief represents a server answering queries on trees which were preprocessed once
+ **/
+typedef struct QueryServer
+{
+    TreeIndex **trees; /** the preprocessed trees, in the order of the trees file**/
+    int treesCount; /** the amount of trees**/
+    int listenFd; /** the listening socket, -1 when stdin is served**/
+    int *clientFds; /** the connection every worker serves, -1 while it waits for one**/
+    int workersCount; /** the amount of workers accepting connections**/
+    bool stopped; /** set by the shutdown request**/
+} QueryServer;
+
+/**
+ * @brief represents the state of a single connection to the server. The trees are shared by all the connections,
+ * the weights added to the vertices belong to the connection
+ **/
+typedef struct ServerSession
+{
+    QueryServer *server; /** the server the connection belongs to**/
+    QueryEngine *engines; /** an engine for every tree, its index is NULL until the tree is first queried**/
+    int current; /** the tree the queries are answered on**/
+} ServerSession;
+
+/**
+ * @brief represents the canonical form of a tree: two trees have the same canonical form exactly when they are
+ * isomorphic. A tree is either rooted at its root, or compared unrooted by rooting it at its center, or at a virtual
+ * vertex between its two centers
+ **/
+typedef struct CanonicalTree
+{
+    int verticesCount; /** the amount of vertices of the tree**/
+    int centersCount; /** the amount of centers the tree was rooted at, 0 when it was rooted at its root**/
+    int *encoding; /** for every level from the deepest up: its size, then the sorted tuples of its vertices**/
+    int encodingLength; /** the length of the encoding**/
+    uint64_t hash; /** the hash of the encoding**/
+} CanonicalTree;
+
+/**
+ * @brief represents the buffers used for finding the canonical form of a tree (AHU). The vertices of every level
+ * are named by the rank of the tuple of the names of their children, from the deepest level up
+ **/
+typedef struct CanonicalWorkspace
+{
+    int capacity; /** the amount of vertices, including a virtual root, the buffers can hold**/
+    int *order; /** the vertices level after level, from the roots**/
+    int *parent; /** the parent of every vertex, -1 for a root**/
+    int *depth; /** the distance of every vertex from the roots, -1 before it is reached**/
+    int *name; /** the rank of the tuple of every vertex among the tuples of its level**/
+    int *childCount; /** the amount of children of every vertex, the length of its tuple**/
+    int *tupleStart; /** the start of the tuple of every vertex in the tuples**/
+    int *tupleFill; /** the amount of names already written to the tuple of every vertex**/
+    int *tuples; /** the names of the children of every vertex, in increasing order**/
+    int *counts; /** the counters of a counting sort**/
+    int *pairPosition; /** the position of every name in the tuples of a level, sorted by position and name**/
+    int *pairName; /** the name of every such pair**/
+    int *sortedPosition; /** the pairs sorted by name only**/
+    int *sortedName; /** the names of the pairs sorted by name only**/
+    int *positionStart; /** the first distinct pair of every position**/
+    int *byLength; /** the vertices of a level sorted by the lengths of their tuples**/
+    int *queue; /** the vertices of a level sorted by the suffixes of their tuples**/
+    int *next; /** the vertex after every vertex in its bucket**/
+    int *bucketHead; /** the first vertex of the bucket of every name, -1 for an empty bucket**/
+    int *bucketTail; /** the last vertex of the bucket of every name**/
+} CanonicalWorkspace;
+
+/**
+ * @brief represents a single graph file of an isomorphism manifest
+ **/
+typedef struct IsomorphismJob
+{
+    char *file; /** the path of the graph file**/
+    CanonicalTree canonical; /** the canonical form of the tree, its encoding is NULL when the job failed**/
+    char *error; /** the error message of the job, NULL when it succeeded**/
+    int classStart; /** the place of the first tree of the class of the tree, among the sorted trees**/
+} IsomorphismJob;
+
+/**
+ * @brief represents the graph files of an isomorphism manifest, shared by all the threads finding their canonical
+ * forms
+ **/
+typedef struct Isomorphism
+{
+    IsomorphismJob *jobs; /** the jobs, in the order of the manifest**/
+    int jobsCount; /** the total amount of jobs**/
+    int nextJob; /** the first job no thread took yet. Taken atomically**/
+    bool rooted; /** whenever the trees are compared as rooted at their roots, otherwise at their centers**/
+    CanonicalWorkspace **workspaces; /** the buffers of every thread, NULL until its first job**/
+} Isomorphism;
+
+/**
+ * @brief represents the buffers of a bfs from up to BIT_PARALLEL_SOURCES sources at once. Every vertex holds a word
+ * with a bit for every source, so a single pass over the edges of a level advances the traversals of all of them
+ **/
+typedef struct BitParallelBfs
+{
+    uint64_t *seen; /** the sources which reached every vertex, 0 outside the last traversal**/
+    uint64_t *frontier; /** the sources which reached every vertex in the last level**/
+    uint64_t *next; /** the sources which reach every vertex in the next level**/
+    int *active; /** the vertices with a non empty frontier**/
+    int *nextActive; /** the vertices with a non empty next frontier**/
+    int *touched; /** the vertices with a non empty seen word, cleared before the next traversal**/
+    int touchedCount; /** the amount of touched vertices**/
+} BitParallelBfs;
+
+/**
+ * @brief represents a general graph, which may have cycles and several components, with the buffers of the
+ * traversals finding its distances. The distances are counted in edges
+ **/
+typedef struct GeneralGraph
+{
+    int verticesCount; /** the total amount of vertices in the graph**/
+    int edgesCount; /** the total edge count**/
+    int *adjacencyOffsets; /** the neighbors of vertex v are adjacency[adjacencyOffsets[v]..adjacencyOffsets[v+1])**/
+    int *adjacency; /** the neighbors of all the vertices, stored contiguously**/
+    int componentsCount; /** the amount of connected components**/
+    int *componentStarts; /** a vertex of every component**/
+    int *dist; /** the distance of every vertex from the start of the last bfs, -1 outside of it**/
+    int *parent; /** the vertex every vertex was reached from by the last bfs, -1 for its start**/
+    int *order; /** the vertices reached by the last bfs, in the order they were reached**/
+    int orderCount; /** the amount of vertices reached by the last bfs**/
+    int *rootOrder; /** the vertices of a component in the order of a bfs from its center, kept by iFUB**/
+    int *rootDist; /** the distances of these vertices from the center**/
+} GeneralGraph;
+
+/**
+ * @brief represents the eccentricities of all the vertices of a general graph, found in parallel by bit parallel
+ * traversals from batches of BIT_PARALLEL_SOURCES vertices
+ **/
+typedef struct Eccentricities
+{
+    GeneralGraph *graph; /** the graph, shared by all the threads**/
+    int *eccentricity; /** the largest distance from every vertex to a vertex of its component**/
+    int *sources; /** the vertices in the order of a bfs of every component, so every batch holds close vertices
+                   * whose traversals reach most vertices at the same levels**/
+    int batchesCount; /** the amount of batches of vertices**/
+    int nextBatch; /** the first batch no thread took yet. Taken atomically**/
+    BitParallelBfs **workspaces; /** the buffers of every thread**/
+} Eccentricities;
+
+// ------------------------------ function prototype --------------------
+
+int validateVertexAmountLine(char *str);
+
+int parseDigits(const char *str, uint64_t *value);
+
+bool tokenizeRow(GraphRows *rows, char *line, int rowIndex);
+
+void appendNeighbor(GraphRows *rows, int neighbor, int weight);
+
+void initGraphRows(GraphRows *rows, int verticesCount);
+
+void freeGraphRows(GraphRows *rows);
+
+size_t getGraphRowsBytes(GraphRows *rows);
+
+bool parseGraphFile(GraphRows *rows, char *file, int maxVertexKey, bool requireTree, FILE *errorOut);
+
+void initArena(Arena *arena);
+
+void *arenaAlloc(Arena *arena, size_t size);
+
+void freeArena(Arena *arena);
+
+DisjointSets *initDisjointSets(int verticesCount);
+
+void freeDisjointSets(DisjointSets **setsPtr);
+
+int findSet(DisjointSets *sets, int vertexKey);
+
+bool unionSets(DisjointSets *sets, int uVertexKey, int vVertexKey);
+
+bool addTreeEdges(DisjointSets *sets, GraphRows *rows, int rowIndex, int *edgesCount, int maxEdgesCount);
+
+int findLeafIndex(Graph *graph);
+
+bool setRootVertexKey(Graph *graph);
+
+int getVertexDeg(Graph *graph, int vertexKey);
+
+void attachEdges(Graph *graph, GraphRows *rows);
+
+void addEdge(Graph *graph, int uVertexIndex, int vVertexIndex);
+
+void addWeightedEdge(Graph *graph, int uVertexIndex, int vVertexIndex, int weight);
+
+bool isTree(Graph *graph, TreeAnalysis *analysis);
+
+bool isConnected(Graph *graph, TreeAnalysis *analysis);
+
+BfsWorkspace *initBfsWorkspace(int verticesCount);
+
+void freeBfsWorkspace(BfsWorkspace **workspacePtr);
+
+int bfs(Graph *graph, BfsWorkspace *workspace, int startVertexKey, DistanceFromNode distFromVertex,
+        int *traverseSource);
+
+int traverseGraph(Graph *graph, TreeAnalysis *analysis, int startVertexKey, DistanceFromNode distFromVertex,
+                  int *traverseSource);
+
+Graph *initGraph(int verticesCount);
+
+Vertex *createVertex(Graph *graph, int vertexKey);
+
+TreeAnalysis *initTreeAnalysis(int verticesCount);
+
+void freeTreeAnalysis(TreeAnalysis **analysisPtr);
+
+int findGraphDiameter(Graph *graph, TreeAnalysis *analysis);
+
+void findBranchLengths(Graph *graph, TreeAnalysis *analysis);
+
+void findTreeDistanceInfo(Graph *graph, TreeAnalysis *analysis);
+
+void printTreeDistanceInfo(Graph *graph, TreeAnalysis *analysis);
+
+int findShortestPath(TreeAnalysis *analysis, int verticesCount, int uVertexKey, int vVertexKey, int *path);
+
+int printShortestPath(Graph *graph, TreeAnalysis *analysis, int uVertexKey, int vVertexKey);
+
+void startBfsGeneration(BfsWorkspace *workspace);
+
+int findWeightedDistances(Graph *graph, BfsWorkspace *workspace, int startVertexKey, long long *weightedDist);
+
+void findWeightedDistanceInfo(Graph *graph, TreeAnalysis *analysis);
+
+long long findWeightedPathLength(TreeAnalysis *analysis, int *path, int pathLength);
+
+void printTreeInfo(Graph *graph, TreeAnalysis *analysis, int uVertexKey, int vVertexKey);
+
+void deleteAllEdges(Graph **graphPtr);
+
+void freeGraph(Graph **graphPtr);
+
+int nonNumerical(char *str);
+
+bool containsNumber(char *str);
+
+int runMode(int argc, char *argv[]);
+
+bool loadTree(char *file, Graph **graphPtr, TreeAnalysis **analysisPtr);
+
+TreeIndex *buildTreeIndex(Graph *graph, TreeAnalysis *analysis);
+
+void buildEulerTour(Graph *graph, TreeIndex *index);
+
+void buildSparseTable(TreeIndex *index);
+
+void buildAdjacencyArrays(Graph *graph, int *adjacencyOffsets, int *adjacency);
+
+void freeTreeIndex(TreeIndex **indexPtr);
+
+int floorLog2(unsigned int value);
+
+int findLca(TreeIndex *index, int uVertexKey, int vVertexKey);
+
+long long findTreeDistance(TreeIndex *index, int uVertexKey, int vVertexKey);
+
+void printTreePath(QueryEngine *engine, int uVertexKey, int vVertexKey, FILE *out);
+
+bool queryPath(QueryEngine *engine, long *args, FILE *out);
+
+bool queryDistance(QueryEngine *engine, long *args, FILE *out);
+
+bool queryLca(QueryEngine *engine, long *args, FILE *out);
+
+bool isAncestor(TreeIndex *index, int uVertexKey, int vVertexKey);
+
+PathDecomposition *initPathDecomposition(TreeIndex *index);
+
+void freePathDecomposition(PathDecomposition **pathsPtr);
+
+void pushPendingWeight(PathDecomposition *paths, int node, int rangeLength);
+
+void addRangeWeight(PathDecomposition *paths, int node, int nodeStart, int nodeEnd, int start, int end,
+                    long long weight);
+
+void findRangeWeights(PathDecomposition *paths, int node, int nodeStart, int nodeEnd, int start, int end,
+                      long long *sum, long long *max);
+
+void addPathWeight(QueryEngine *engine, int uVertexKey, int vVertexKey, long long weight);
+
+void findPathWeights(QueryEngine *engine, int uVertexKey, int vVertexKey, long long *sum, long long *max);
+
+bool querySubtreeSize(QueryEngine *engine, long *args, FILE *out);
+
+bool queryIsAncestor(QueryEngine *engine, long *args, FILE *out);
+
+bool queryAddWeight(QueryEngine *engine, long *args, FILE *out);
+
+bool querySubtreeSum(QueryEngine *engine, long *args, FILE *out);
+
+bool queryPathSum(QueryEngine *engine, long *args, FILE *out);
+
+bool queryPathMax(QueryEngine *engine, long *args, FILE *out);
+
+bool queryPathAdd(QueryEngine *engine, long *args, FILE *out);
+
+void initQueryEngine(QueryEngine *engine, TreeIndex *index);
+
+void freeQueryEngine(QueryEngine *engine);
+
+bool executeQuery(QueryEngine *engine, char *line, FILE *out);
+
+bool runQueryFile(QueryEngine *engine, char *file, FILE *out);
+
+int runQueryMode(char *argv[]);
+
+size_t getIndexArraysSize(IndexHeader *header);
+
+bool writeTreeIndex(TreeIndex *index, char *file);
+
+TreeIndex *mapTreeIndex(char *file);
+
+bool isValidTreeIndex(TreeIndex *index);
+
+bool queryMetrics(QueryEngine *engine, long *args, FILE *out);
+
+int runBuildIndexMode(char *argv[]);
+
+int runQueryIndexMode(char *argv[]);
+
+bool readGraph(char *file, int maxVertexKey, Graph **graphPtr, Diagnostics *diagnostics, FILE *errorOut);
+
+bool isBinaryGraphFile(char *file);
+
+bool readVarint(unsigned char **cursor, unsigned char *end, uint32_t *value);
+
+bool validateBinaryRow(unsigned char **cursor, unsigned char *end, int rowIndex, int numOfVertices);
+
+bool addBinaryRowEdges(Graph *graph, DisjointSets *sets, unsigned char **cursor, int rowIndex, int *edgesCount);
+
+bool parseBinaryGraphFile(char *file, int maxVertexKey, Graph **graphPtr, FILE *errorOut);
+
+void writeVarint(FILE *fp, uint32_t value);
+
+bool writeBinaryGraph(GraphRows *rows, char *file);
+
+int runConvertMode(char *argv[]);
+
+bool isPruferFile(char *file);
+
+bool readPruferNumber(char **cursor, char *end, uint64_t *value, bool *found);
+
+bool parsePruferFile(char *file, int maxVertexKey, Graph **graphPtr, FILE *errorOut);
+
+void encodePruferSequence(int *parent, int verticesCount, int *sequence);
+
+bool writePruferFile(int *sequence, int verticesCount, char *file);
+
+int runExportPruferMode(char *argv[]);
+
+void sortVerticesByDepth(Graph *graph, TreeAnalysis *analysis, TreeMetrics *metrics, int *order);
+
+TreeMetrics *findTreeMetrics(Graph *graph, TreeAnalysis *analysis);
+
+void findCentersAndCentroids(Graph *graph, TreeAnalysis *analysis, TreeMetrics *metrics);
+
+void freeTreeMetrics(TreeMetrics **metricsPtr);
+
+void printVerticesLine(char *msg, int *vertices, int count);
+
+void printLengthsLine(char *msg, long long *lengths, int count);
+
+void printTreeMetrics(Graph *graph, TreeAnalysis *analysis, TreeMetrics *metrics);
+
+int runMetricsMode(char *argv[]);
+
+void reserveDynamicTree(DynamicTree *tree, int verticesCount);
+
+void setDynamicVertex(DynamicTree *tree, int vertexKey, int parentKey);
+
+void addDynamicVertices(DynamicTree *tree, int *parent, int count, int attachTo);
+
+DynamicTree *initDynamicTree(TreeAnalysis *analysis, int verticesCount);
+
+void freeDynamicTree(DynamicTree **treePtr);
+
+int findDynamicAncestor(DynamicTree *tree, int vertexKey, int depth);
+
+int findDynamicLca(DynamicTree *tree, int uVertexKey, int vVertexKey);
+
+int findDynamicDistance(DynamicTree *tree, int uVertexKey, int vVertexKey);
+
+void findRangeDiameter(DynamicTree *tree, int firstVertexKey, int endVertexKey, int *ends, int *diameter);
+
+void mergeDiameter(DynamicTree *tree, int *ends, int diameter);
+
+bool parseVertexArg(DynamicTree *tree, char *args, char **end, int *vertexKey);
+
+bool operationAddLeaf(DynamicTree *tree, char *args, FILE *out);
+
+bool operationAttachSubtree(DynamicTree *tree, char *args, FILE *out);
+
+bool operationInfo(DynamicTree *tree, char *args, FILE *out);
+
+bool executeDynamicOperation(DynamicTree *tree, char *line, FILE *out);
+
+int runDynamicMode(char *argv[]);
+
+uint64_t nextRandom(uint64_t *randomState);
+
+void generatePath(int *parent, int verticesCount, int arity, uint64_t *randomState);
+
+void generateStar(int *parent, int verticesCount, int arity, uint64_t *randomState);
+
+void generateKary(int *parent, int verticesCount, int arity, uint64_t *randomState);
+
+void decodePruferSequence(int *sequence, int verticesCount, int *parent);
+
+void generatePrufer(int *parent, int verticesCount, int arity, uint64_t *randomState);
+
+void generateCaterpillar(int *parent, int verticesCount, int arity, uint64_t *randomState);
+
+const TreeGenerator *findTreeGenerator(char *kind, int *arity);
+
+void findExtraEdge(int *parent, int verticesCount, uint64_t *randomState, int *extraEdge);
+
+bool writeGeneratedGraph(int *parent, int verticesCount, int *extraEdge, char *file);
+
+bool generateGraphFile(char *kind, int verticesCount, char *file);
+
+int runGenerateMode(char *argv[]);
+
+double getSeconds();
+
+void runBenchmark(char *kind, int verticesCount, char *file);
+
+int runBenchmarkMode(char *argv[]);
+
+Diagnostics *initDiagnostics();
+
+void recordPhase(Diagnostics *diagnostics, char *name, double start);
+
+long getPeakRssKb();
+
+void reportDiagnostics(Diagnostics *diagnostics, Graph *graph);
+
+void freeDiagnostics(Diagnostics **diagnosticsPtr);
+
+bool readManifest(char *file, Batch *batch);
+
+void printJsonString(FILE *out, char *str, size_t length);
+
+void runBatchJob(BatchJob *job, int jobIndex, BatchWorker *worker);
+
+void batchTask(void *batchArgs, int threadIndex, int threadCount);
+
+int runBatchMode(char *argv[]);
+
+int findSetConcurrent(DisjointSets *sets, int vertexKey);
+
+bool unionSetsConcurrent(DisjointSets *sets, int uVertexKey, int vVertexKey);
+
+void forestUnionTask(void *forestArgs, int threadIndex, int threadCount);
+
+void forestLabelTask(void *forestArgs, int threadIndex, int threadCount);
+
+int compareComponents(const void *first, const void *second);
+
+void findForestComponents(Forest *forest);
+
+int traverseComponent(Graph *graph, int startVertexKey, long long *length, int *order);
+
+void analyzeComponent(Forest *forest, ForestComponent *component);
+
+void forestComponentsTask(void *forestArgs, int threadIndex, int threadCount);
+
+void printForestComponents(Forest *forest);
+
+int runForestMode(char *argv[]);
+
+int getOriginalKey(Graph *graph, int vertexKey);
+
+void findBfsOrder(Graph *graph, int *order, int *parent);
+
+void findCuthillMcKeeOrder(Graph *graph, int *order);
+
+int *relabelGraph(Graph **graphPtr, bool reverseCuthillMcKee);
+
+bool readTreesFile(char *file, QueryServer *server);
+
+bool executeServerRequest(ServerSession *session, char *line, FILE *out);
+
+void serveSession(QueryServer *server, FILE *in, FILE *out);
+
+void stopServer(QueryServer *server);
+
+void serveTask(void *serverArgs, int threadIndex, int threadCount);
+
+bool listenOnSocket(QueryServer *server, char *path);
+
+int runServeMode(char *argv[]);
+
+CanonicalWorkspace *initCanonicalWorkspace(int capacity);
+
+void freeCanonicalWorkspace(CanonicalWorkspace **workspacePtr);
+
+int findBfsLevels(Graph *graph, int *roots, int rootsCount, int *order, int *parent, int *depth);
+
+int findTreeCenters(Graph *graph, CanonicalWorkspace *workspace, int *centers);
+
+void appendToBucket(CanonicalWorkspace *workspace, int vertexKey, int name);
+
+void sortLevelTuples(CanonicalWorkspace *workspace, int *vertices, int count, int namesCount);
+
+bool isSameTuple(CanonicalWorkspace *workspace, int uVertexKey, int vVertexKey);
+
+bool findCanonicalTree(Graph *graph, bool rooted, CanonicalWorkspace *workspace, CanonicalTree *canonical);
+
+bool isSameCanonicalTree(CanonicalTree *first, CanonicalTree *second);
+
+int compareCanonicalJobs(const void *first, const void *second);
+
+bool readIsomorphismManifest(char *file, Isomorphism *isomorphism);
+
+void runIsomorphismJob(IsomorphismJob *job, bool rooted, CanonicalWorkspace **workspacePtr);
+
+void isomorphismTask(void *isomorphismArgs, int threadIndex, int threadCount);
+
+void printIsomorphismClasses(Isomorphism *isomorphism, IsomorphismJob **sorted, int sortedCount);
+
+int groupIsomorphicTrees(char *manifest, bool rooted);
+
+int runIsomorphismMode(char *argv[]);
+
+int runRootedIsomorphismMode(char *argv[]);
+
+bool readGeneralGraph(char *file, int maxVertexKey, Graph **graphPtr);
+
+GeneralGraph *initGeneralGraph(Graph *graph);
+
+void freeGeneralGraph(GeneralGraph **graphPtr);
+
+BitParallelBfs *initBitParallelBfs(int verticesCount);
+
+void freeBitParallelBfs(BitParallelBfs **traversalPtr);
+
+int findGeneralBfs(GeneralGraph *graph, int startVertexKey);
+
+void findBatchEccentricities(GeneralGraph *graph, BitParallelBfs *traversal, int *sources, int sourcesCount,
+                             int *eccentricity);
+
+int findComponentDiameter(GeneralGraph *graph, BitParallelBfs *traversal, int startVertexKey);
+
+int findGeneralDiameter(GeneralGraph *graph);
+
+void printGeneralPath(GeneralGraph *graph, int uVertexKey, int vVertexKey);
+
+int runGraphMode(char *argv[]);
+
+void eccentricitiesTask(void *eccentricitiesArgs, int threadIndex, int threadCount);
+
+void printTreeEccentricities(Graph *graph, TreeAnalysis *analysis);
+
+int runEccentricitiesMode(char *argv[]);
+
+int getThreadCount();
+
+void *runWorker(void *workerArgs);
+
+ThreadPool *initThreadPool(int threadCount);
+
+void runParallel(ThreadPool *pool, ParallelTask task, void *taskArgs);
+
+void freeThreadPool(ThreadPool **poolPtr);
+
+void getThreadRange(long length, int threadIndex, int threadCount, long *start, long *end);
+
+ParallelBfs *initParallelBfs(Graph *graph, int threadCount);
+
+void freeParallelBfs(ParallelBfs **traversalPtr);
+
+int getParallelBfsDeg(ParallelBfs *traversal, int vertexKey);
+
+bool isBitSet(uint64_t *bitmap, int vertexKey);
+
+bool setBitAtomic(uint64_t *bitmap, int vertexKey);
+
+void topDownStepSequential(ParallelBfs *traversal);
+
+void topDownStepTask(void *traversalArgs, int threadIndex, int threadCount);
+
+void bottomUpStepTask(void *traversalArgs, int threadIndex, int threadCount);
+
+void fillFrontierTask(void *traversalArgs, int threadIndex, int threadCount);
+
+void fillSourcesTask(void *traversalArgs, int threadIndex, int threadCount);
+
+int parallelBfs(ParallelBfs *traversal, int startVertexKey, DistanceFromNode distFromVertex, int *traverseSource);
+
+// ------------------------------ modes and queries ---------------------
+
+/**
+ * @brief the additional modes of the analyzer
+ **/
+static const AnalyzerMode ANALYZER_MODES[] = {
+        {"--query",              4, QUERY_USAGE_MSG,              runQueryMode},
+        {"--build-index",        4, BUILD_INDEX_USAGE_MSG,        runBuildIndexMode},
+        {"--query-index",        4, QUERY_INDEX_USAGE_MSG,        runQueryIndexMode},
+        {"--convert",            4, CONVERT_USAGE_MSG,            runConvertMode},
+        {"--export-prufer",      4, EXPORT_PRUFER_USAGE_MSG,      runExportPruferMode},
+        {"--metrics",            3, METRICS_USAGE_MSG,            runMetricsMode},
+        {"--dynamic",            4, DYNAMIC_USAGE_MSG,            runDynamicMode},
+        {"--generate",           5, GENERATE_USAGE_MSG,           runGenerateMode},
+        {"--benchmark",          5, BENCHMARK_USAGE_MSG,          runBenchmarkMode},
+        {"--batch",              3, BATCH_USAGE_MSG,              runBatchMode},
+        {"--forest",             3, FOREST_USAGE_MSG,             runForestMode},
+        {"--serve",              4, SERVE_USAGE_MSG,              runServeMode},
+        {"--isomorphism",        3, ISOMORPHISM_USAGE_MSG,        runIsomorphismMode},
+        {"--rooted-isomorphism", 3, ROOTED_ISOMORPHISM_USAGE_MSG, runRootedIsomorphismMode},
+        {"--graph",              5, GRAPH_USAGE_MSG,              runGraphMode},
+        {"--eccentricities",     3, ECCENTRICITIES_USAGE_MSG,     runEccentricitiesMode},
+};
+
+/**
+ * @brief the queries that can appear in a queries file
+ **/
+static const TreeQuery TREE_QUERIES[] = {
+        {"path",         2, 2, queryPath},
+        {"distance",     2, 2, queryDistance},
+        {"lca",          2, 2, queryLca},
+        {"metrics",      0, 0, queryMetrics},
+        {"subtree-size", 1, 1, querySubtreeSize},
+        {"is-ancestor",  2, 2, queryIsAncestor},
+        {"add-weight",   2, 1, queryAddWeight},
+        {"subtree-sum",  1, 1, querySubtreeSum},
+        {"path-sum",     2, 2, queryPathSum},
+        {"path-max",     2, 2, queryPathMax},
+        {"path-add",     3, 2, queryPathAdd},
+};
+
+/**
+ * @brief the operations that can appear in an operations file of the dynamic mode
+ **/
+static const DynamicOperation DYNAMIC_OPERATIONS[] = {
+        {"add-leaf",       operationAddLeaf},
+        {"attach-subtree", operationAttachSubtree},
+        {"info",           operationInfo},
+};
+
+/**
+ * @brief the kinds of trees that can be generated
+ **/
+static const TreeGenerator TREE_GENERATORS[] = {
+        {"path",        false, false, generatePath},
+        {"star",        false, false, generateStar},
+        {KARY_PREFIX,   true,  false, generateKary},
+        {"prufer",      false, false, generatePrufer},
+        {"caterpillar", false, false, generateCaterpillar},
+        {"near-tree",   false, true,  generatePrufer},
+};
+
+/**
+ * @brief the powers of ten up to the value of a word of digits
+ **/
+static const uint64_t POWERS_OF_TEN[SWAR_WORD_LENGTH + 1] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+};
+
+// ------------------------------ functions -----------------------------
+
+/**
+ * @brief Analzing a txt file representng a graph.Expect 3 arguments <Graph File Path> <First Vertex> <Second Vertex>
+ * @param argc
+ * @param argv
+ * */
+int main(int argc, char *argv[])
+{
+
+    // graph related information
+    Graph *graph;
+    TreeAnalysis *analysis;
+    int firstVertex, secondVertex;
+
+    // the measurements of the run, when they are enabled
+    Diagnostics *diagnostics;
+    double start;
+    bool treeFound;
+
+    // the order the vertices are relabeled in, when it is selected
+    char *relabelOrder = getenv(RELABEL_ENV_VAR);
+    int *newKeys;
+
+    // check whenever an additional mode was selected
+    if ((argc > MODE_FLAG_INDEX) &&
+        (strncmp(argv[MODE_FLAG_INDEX], MODE_FLAG_PREFIX, strlen(MODE_FLAG_PREFIX)) == 0))
+    {
+        return runMode(argc, argv);
+    }
+
+    // check the total amount of given arguments
+    if (argc != VALID_ARG_COUNT)
+    {
+        fprintf(stderr, "%s", INVALID_USAGE_MSG);
+        return EXIT_FAILURE;
+    }
+
+    // check whenver the given number represents valid integers
+    if ((nonNumerical(argv[FIRST_VERTEX_INDEX]) != 0) ||
+        (nonNumerical(argv[SECOND_VERTEX_INDEX]) != 0))
+    {
+        fprintf(stderr, "%s", INVALID_INPUT_MSG);
+        return EXIT_FAILURE;
+    }
+
+    // save the vertex user input as integers
+    firstVertex = (int) strtod(argv[FIRST_VERTEX_INDEX], NULL);
+    secondVertex = (int) strtod(argv[SECOND_VERTEX_INDEX], NULL);
+
+    /* parse the given file and create the graph .exit the program case something went wrong.
+     * The given vertex values are checked against the graph size before any edge is read*/
+    diagnostics = initDiagnostics();
+    if (!readGraph(argv[FILE_PATH_INDEX], (firstVertex > secondVertex) ? firstVertex : secondVertex, &graph,
+                   diagnostics, stderr))
+    {
+        reportDiagnostics(diagnostics, NULL);
+        freeDiagnostics(&diagnostics);
+        return EXIT_FAILURE;
+    }
+
+    // relabel the vertices so every traversal reads the memory of close vertices together
+    if ((relabelOrder != NULL) &&
+        ((strcmp(relabelOrder, RELABEL_BFS) == 0) || (strcmp(relabelOrder, RELABEL_RCM) == 0)))
+    {
+        start = getSeconds();
+        newKeys = relabelGraph(&graph, strcmp(relabelOrder, RELABEL_RCM) == 0);
+        firstVertex = newKeys[firstVertex];
+        secondVertex = newKeys[secondVertex];
+        free(newKeys);
+        recordPhase(diagnostics, "relabelGraph", start);
+    }
+
+    // check whenever a tree was provided. This also sets the root of the tree
+    analysis = initTreeAnalysis(graph->verticesCount);
+    analysis->diagnostics = diagnostics;
+    start = getSeconds();
+    treeFound = isTree(graph, analysis);
+    recordPhase(diagnostics, "isTree", start);
+    if (!treeFound)
+    {
+        fprintf(stderr, "%s", GRAPH_NOT_TREE_MSG);
+        reportDiagnostics(diagnostics, graph);
+        freeDiagnostics(&diagnostics);
+        freeTreeAnalysis(&analysis);
+        freeGraph(&graph);
+        return EXIT_FAILURE;
+    }
+
+    printTreeInfo(graph, analysis, firstVertex, secondVertex);
+    reportDiagnostics(diagnostics, graph);
+
+    // delete the graph and the analysis buffers
+    freeDiagnostics(&diagnostics);
+    freeTreeAnalysis(&analysis);
+    freeGraph(&graph);
+
+    return EXIT_SUCCESS;
+
+}
+
+/**
+ * @brief Checks whenever the a line in the text file representing a vertex edge relation is valid
+ * @param str
+ * */
+int validateVertexAmountLine(char *str)
+{
+    char *nextNumber = str;
+
+    // should contain number
+    if (!containsNumber(str))
+    {
+        return false;
+    }
+
+
+    strtol(nextNumber, &nextNumber, 10);
+
+    // should only contain a single number
+    if (strlen(nextNumber) != 0)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parses the digits at the start of a string, a word of eight characters at a time: the digits of the word
+ * are found and combined with a few multiplications of the whole word, instead of a multiplication for every digit.
+ * The string must be readable for SWAR_WORD_LENGTH - 1 bytes after its terminator
+ * @param str
+ * @param value set to the parsed number, valid when there are at most MAX_PARSED_DIGITS digits
+ * @return the amount of digits at the start of the string
+ * */
+int parseDigits(const char *str, uint64_t *value)
+{
+    uint64_t word;
+    uint64_t nonDigits;
+    int digitsCount = 0;
+    int wordDigits = SWAR_WORD_LENGTH;
+
+    *value = 0;
+    while (wordDigits == SWAR_WORD_LENGTH)
+    {
+        memcpy(&word, str + digitsCount, sizeof(word));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        word = __builtin_bswap64(word);
+#endif
+
+        // the first character of the word is its lowest byte, a borrow only changes the bytes after a non digit
+        word -= SWAR_ZERO_DIGITS;
+        nonDigits = (word | (word + SWAR_DIGIT_LIMIT)) & SWAR_HIGH_BITS;
+        wordDigits = (nonDigits == 0) ? SWAR_WORD_LENGTH : (__builtin_ctzll(nonDigits) / CHAR_BIT);
+        if (wordDigits == 0)
+        {
+            break;
+        }
+
+        // drop the bytes after the digits, the digits become the last ones of a number of eight digits
+        word <<= CHAR_BIT * (SWAR_WORD_LENGTH - wordDigits);
+        word = (word * 10 + (word >> 8)) & SWAR_PAIRS_MASK;
+        word = (word * 100 + (word >> 16)) & SWAR_QUADS_MASK;
+        word = (word * 10000 + (word >> 32)) & SWAR_OCTET_MASK;
+
+        *value = *value * POWERS_OF_TEN[wordDigits] + word;
+        digitsCount += wordDigits;
+    }
+
+    return digitsCount;
+}
+
+/**
+ * @brief Parses a row of a text graph file, after its terminators were removed, in a single pass: the characters
+ * are validated while the neighbors and their weights are parsed and appended to the rows
+ * @param rows the rows parsed so far, the row is appended to them
+ * @param line the row, readable for SWAR_WORD_LENGTH - 1 bytes after its terminator
+ * @param rowIndex the vertex the row belongs to
+ * @return false when the row is not valid
+ * */
+bool tokenizeRow(GraphRows *rows, char *line, int rowIndex)
+{
+    char *c = line;
+    uint64_t neighbor;
+    uint64_t weight;
+    int digitsCount;
+    size_t spaces = 0;
+    int i;
+
+    rows->offsets[rowIndex + 1] = rows->edgesCount;
+
+    // check leaf
+    if (strcmp(IS_LEAF, line) == 0)
+    {
+        return true;
+    }
+
+    while (*c != '\0')
+    {
+        spaces = strspn(c, " ");
+        c += spaces;
+        if (*c == '\0')
+        {
+            break;
+        }
+
+        digitsCount = parseDigits(c, &neighbor);
+        if ((digitsCount == 0) || (digitsCount > MAX_PARSED_DIGITS) || (neighbor >= (uint64_t) rows->verticesCount))
+        {
+            return false;
+        }
+        c += digitsCount;
+
+        // a neighbor may be followed by the strictly positive weight of the edge to it, as in "3:10"
+        weight = DEFAULT_EDGE_WEIGHT;
+        if (*c == WEIGHT_SEPARATOR)
+        {
+            digitsCount = parseDigits(c + 1, &weight);
+            if ((digitsCount == 0) || (digitsCount > MAX_WEIGHT_DIGITS) || (weight == 0))
+            {
+                return false;
+            }
+            c += digitsCount + 1;
+
+            if (rows->weights == NULL)
+            {
+                rows->weights = malloc(rows->capacity * sizeof(int));
+                for (i = 0; i < rows->edgesCount; i++)
+                {
+                    rows->weights[i] = DEFAULT_EDGE_WEIGHT;
+                }
+            }
+        }
+
+        if ((*c != ' ') && (*c != '\0'))
+        {
+            return false;
+        }
+        spaces = 0;
+
+        appendNeighbor(rows, (int) neighbor, (int) weight);
+    }
+
+    // the run of spaces ending the row, see GraphRows
+    if (rows->edgesCount != rows->offsets[rowIndex])
+    {
+        spaces = (spaces > 0) ? spaces - 1 : 0;
+    }
+    for (; spaces > 0; spaces--)
+    {
+        appendNeighbor(rows, 0, DEFAULT_EDGE_WEIGHT);
+    }
+
+    rows->offsets[rowIndex + 1] = rows->edgesCount;
+
+    return true;
+}
+
+/**
+ * @brief Appends a neighbor to the row parsed last, growing the arrays of the rows when they are full
+ * @param rows
+ * @param neighbor
+ * @param weight the weight of the edge to the neighbor, kept only when the rows have weights
+ * */
+void appendNeighbor(GraphRows *rows, int neighbor, int weight)
+{
+    if (rows->edgesCount == rows->capacity)
+    {
+        rows->capacity *= 2;
+        rows->neighbors = realloc(rows->neighbors, rows->capacity * sizeof(int));
+        if (rows->weights != NULL)
+        {
+            rows->weights = realloc(rows->weights, rows->capacity * sizeof(int));
+        }
+    }
+    rows->neighbors[rows->edgesCount] = neighbor;
+    if (rows->weights != NULL)
+    {
+        rows->weights[rows->edgesCount] = weight;
+    }
+    rows->edgesCount++;
+}
+
+/**
+ * @brief Allocates the rows of a graph file without any neighbors
+ * @param rows
+ * @param verticesCount the amount of rows
+ * */
+void initGraphRows(GraphRows *rows, int verticesCount)
+{
+    rows->verticesCount = verticesCount;
+    rows->offsets = malloc((verticesCount + 1) * sizeof(int));
+    rows->offsets[0] = 0;
+
+    // a tree has one edge less than vertices
+    rows->capacity = (verticesCount > 0) ? verticesCount : 1;
+    rows->neighbors = malloc(rows->capacity * sizeof(int));
+    rows->weights = NULL;
+    rows->edgesCount = 0;
+}
+
+/**
+ * @brief Frees the rows of a graph file
+ * @param rows
+ * */
+void freeGraphRows(GraphRows *rows)
+{
+    free(rows->offsets);
+    free(rows->neighbors);
+    free(rows->weights);
+    memset(rows, 0, sizeof(GraphRows));
+}
+
+/**
+ * @brief Get the amount of bytes allocated for the rows of a graph file
+ * @param rows
+ * */
+size_t getGraphRowsBytes(GraphRows *rows)
+{
+    size_t bytes = 0;
+
+    if (rows->offsets != NULL)
+    {
+        bytes += (rows->verticesCount + 1) * sizeof(int) + rows->capacity * sizeof(int);
+    }
+    if (rows->weights != NULL)
+    {
+        bytes += rows->capacity * sizeof(int);
+    }
+
+    return bytes;
+}
+
+/**
+ * @brief Parses a txt file representing a graph in the given foramt that was provided as input ar.
+ * The edges are checked while they are read, so an input which is not a tree is rejected at the first edge
+ * closing a cycle, or exceeding the n-1 edges of a tree. Every row is read once, see tokenizeRow
+ * @param rows set to the parsed rows. Released by the caller with freeGraphRows, also on failure
+ * @param file
+ * @param maxVertexKey the largest vertex the caller asks about. Input with less vertices is invalid
+ * @param requireTree whenever the edges are checked to form a tree. Otherwise only the format of the rows is checked
+ * @param errorOut the stream to print an error message to
+ * */
+bool parseGraphFile(GraphRows *rows, char *file, int maxVertexKey, bool requireTree, FILE *errorOut)
+{
+    FILE *fp;
+    char line[MAX_ROW_LENGTH + SWAR_WORD_LENGTH];
+    int rowIndex = 0;
+    int edgesCount = 0;
+    size_t rowLength;
+    DisjointSets *sets = NULL;
+    struct stat fileStat;
+    long rowsStart;
+
+    memset(rows, 0, sizeof(GraphRows));
+    memset(line, 0, sizeof(line));
+
+    fp = fopen(file, "r");
+    if (fp == NULL)
+    {
+        fprintf(errorOut, "%s", INVALID_USAGE_MSG);
+        return false;
+    }
+
+    // read the first line and whenever an empty file was given:
+    if (fgets(line, MAX_ROW_LENGTH + 1, fp) == NULL)
+    {
+        fprintf(errorOut, "%s", INVALID_USAGE_MSG);
+        fclose(fp);
+        return false;
+    }
+
+    // remove line terminators
+    sscanf(line, "%[^\r]", line);
+    sscanf(line, "%[^\n]", line);
+
+    // check whenever the first line displays the expected number of rows
+    if ((!validateVertexAmountLine(line)))
+    {
+        fprintf(errorOut, "%s", INVALID_INPUT_MSG);
+        fclose(fp);
+        return false;
+    }
+
+    // get the number of vertices the graph should have
+    rows->verticesCount = (int) strtod(line, NULL);
+
+    // check whenever the vertices asked about are in the graph
+    if (maxVertexKey >= rows->verticesCount)
+    {
+        fprintf(errorOut, "%s", INVALID_INPUT_MSG);
+        fclose(fp);
+        return false;
+    }
+
+    // a file too short for the rows it asks for is rejected before anything is allocated for them
+    rowsStart = ftell(fp);
+    if ((rows->verticesCount > 0) && (rowsStart >= 0) && (fstat(fileno(fp), &fileStat) == 0) &&
+        S_ISREG(fileStat.st_mode) &&
+        ((long long) fileStat.st_size - rowsStart + 1 < (long long) rows->verticesCount * MIN_ROW_BYTES))
+    {
+        fprintf(errorOut, "%s", INVALID_INPUT_MSG);
+        fclose(fp);
+        return false;
+    }
+
+    initGraphRows(rows, rows->verticesCount);
+    if (requireTree)
+    {
+        sets = initDisjointSets(rows->verticesCount);
+    }
+
+
+    // get the the list of adjacent vertices
+    while (fgets(line, MAX_ROW_LENGTH + 1, fp) != NULL)
+    {
+
+        // remove line terminators. A row starting with a terminator keeps it, so it is rejected
+        rowLength = strcspn(line, ROW_TERMINATORS);
+        if (rowLength > 0)
+        {
+            line[rowLength] = '\0';
+        }
+
+        if ((rowIndex >= rows->verticesCount) || (!tokenizeRow(rows, line, rowIndex)))
+        {
+            fprintf(errorOut, "%s", INVALID_INPUT_MSG);
+            if (sets != NULL)
+            {
+                freeDisjointSets(&sets);
+            }
+            fclose(fp);
+            return false;
+        }
+
+        // stop at the first edge which can not be part of a tree
+        if (requireTree && !addTreeEdges(sets, rows, rowIndex, &edgesCount, rows->verticesCount - 1))
+        {
+            fprintf(errorOut, "%s", GRAPH_NOT_TREE_MSG);
+            freeDisjointSets(&sets);
+            fclose(fp);
+            return false;
+        }
+
+        rowIndex++;
+    }
+
+    if (sets != NULL)
+    {
+        freeDisjointSets(&sets);
+    }
+
+    // check the number of rows
+    if (rowIndex < rows->verticesCount)
+    {
+        fprintf(errorOut, "%s", INVALID_INPUT_MSG);
+        fclose(fp);
+        return false;
+    }
+
+    // a forest of n vertices and n-1 edges is a tree
+    if (requireTree && (edgesCount != rows->verticesCount - 1))
+    {
+        fprintf(errorOut, "%s", GRAPH_NOT_TREE_MSG);
+        fclose(fp);
+        return false;
+    }
+
+    fclose(fp);
+    return true;
+
+}
+
+/**
+ * @brief Initialize an empty arena
+ * @param arena
+ * */
+void initArena(Arena *arena)
+{
+    arena->head = NULL;
+    arena->nextBlockSize = ARENA_FIRST_BLOCK_SIZE;
+    arena->allocatedBytes = 0;
+}
+
+/**
+ * @brief Allocate memory from an arena. A new block is allocated only when the current one is full
+ * @param arena
+ * @param size the amount of bytes to allocate
+ * */
+void *arenaAlloc(Arena *arena, size_t size)
+{
+    ArenaBlock *block = arena->head;
+    size_t capacity;
+    void *memory;
+
+    // keep every allocation aligned
+    size = (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+
+    if ((block == NULL) || (block->used + size > block->capacity))
+    {
+        // allocations larger than a block get a block of their own
+        capacity = (size > arena->nextBlockSize) ? size : arena->nextBlockSize;
+        if (arena->nextBlockSize < ARENA_MAX_BLOCK_SIZE)
+        {
+            arena->nextBlockSize *= 2;
+        }
+
+        // the header is padded so the data stays aligned
+        block = malloc(sizeof(ArenaBlock) + ARENA_ALIGNMENT + capacity);
+        block->data = (char *) block + ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1));
+        block->capacity = capacity;
+        block->used = 0;
+        block->next = arena->head;
+        arena->head = block;
+    }
+
+    memory = block->data + block->used;
+    block->used += size;
+    arena->allocatedBytes += size;
+    return memory;
+}
+
+/**
+ * @brief Release all the memory allocated from an arena, one block at a time
+ * @param arena
+ * */
+void freeArena(Arena *arena)
+{
+    ArenaBlock *block = arena->head;
+    ArenaBlock *temp;
+
+    while (block != NULL)
+    {
+        temp = block->next;
+        free(block);
+        block = temp;
+    }
+
+    initArena(arena);
+}
+
+/**
+ * @brief Initialize disjoint sets where every vertex is in a set of its own
+ * @param verticesCount
+ * */
+DisjointSets *initDisjointSets(int verticesCount)
+{
+    DisjointSets *sets = malloc(sizeof(DisjointSets));
+    int i;
+
+    sets->parent = malloc(verticesCount * sizeof(int));
+    sets->size = malloc(verticesCount * sizeof(int));
+
+    for (i = 0; i < verticesCount; i++)
+    {
+        sets->parent[i] = i;
+        sets->size[i] = 1;
+    }
+
+    return sets;
+}
+
+/**
+ * @brief Release the memory allocated to disjoint sets
+ * @param setsPtr
+ * */
+void freeDisjointSets(DisjointSets **setsPtr)
+{
+    free((*setsPtr)->parent);
+    free((*setsPtr)->size);
+    free(*setsPtr);
+    *setsPtr = NULL;
+}
+
+/**
+ * @brief Find the representative of the set of a vertex. Every vertex on the way is linked to its grandparent,
+ * which keeps the trees of the sets shallow
+ * @param sets
+ * @param vertexKey
+ * */
+int findSet(DisjointSets *sets, int vertexKey)
+{
+    while (sets->parent[vertexKey] != vertexKey)
+    {
+        sets->parent[vertexKey] = sets->parent[sets->parent[vertexKey]];
+        vertexKey = sets->parent[vertexKey];
+    }
+
+    return vertexKey;
+}
+
+/**
+ * @brief Merge the sets of two vertices, the smaller set is linked under the larger one
+ * @param sets
+ * @param uVertexKey
+ * @param vVertexKey
+ * @return false when the vertices are already in the same set
+ * */
+bool unionSets(DisjointSets *sets, int uVertexKey, int vVertexKey)
+{
+    int uRoot = findSet(sets, uVertexKey);
+    int vRoot = findSet(sets, vVertexKey);
+    int temp;
+
+    if (uRoot == vRoot)
+    {
+        return false;
+    }
+
+    if (sets->size[uRoot] < sets->size[vRoot])
+    {
+        temp = uRoot;
+        uRoot = vRoot;
+        vRoot = temp;
+    }
+
+    sets->parent[vRoot] = uRoot;
+    sets->size[uRoot] += sets->size[vRoot];
+    return true;
+}
+
+/**
+ * @brief Adds the edges of a parsed row to disjoint sets of the vertices
+ * @param sets
+ * @param rows the rows of the input file, after the row was parsed
+ * @param rowIndex the vertex the row belongs to
+ * @param edgesCount the amount of edges added so far, incremented for every edge in the row
+ * @param maxEdgesCount the maximal amount of edges
+ * @return false when an edge closes a cycle, or there are more than maxEdgesCount edges
+ * */
+bool addTreeEdges(DisjointSets *sets, GraphRows *rows, int rowIndex, int *edgesCount, int maxEdgesCount)
+{
+    int i;
+
+    // the weight of the edge does not matter for the structure of the tree
+    for (i = rows->offsets[rowIndex]; i < rows->offsets[rowIndex + 1]; i++)
+    {
+        (*edgesCount)++;
+        if ((*edgesCount > maxEdgesCount) || (!unionSets(sets, rowIndex, rows->neighbors[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Find some leaf in the graph
+ * @param graph
+ * */
+int findLeafIndex(Graph *graph)
+{
+    int length = graph->verticesCount;
+    int i = 0;
+    int leafIndex = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        leafIndex = i;
+        if (graph->listOfAdjacent[i] == NULL)
+        {
+            continue;
+        }
+
+        // check whenever the vertex is a leaf
+        if (graph->listOfAdjacent[i]->next == NULL)
+        {
+            break;
+        }
+
+    }
+    return leafIndex;
+
+}
+
+
+/**
+ * @brief Find out the root of the graph
+ * @param graph
+ * @return false when the ancestors of a leaf form a cycle, in which case the graph is not a tree
+ * */
+bool setRootVertexKey(Graph *graph)
+{
+    int leafIndex = findLeafIndex(graph);
+    int rootIndex = leafIndex;
+    int steps = 0;
+    Vertex *currentVertex;
+
+    while (graph->listOfAncestors[rootIndex] != NULL)
+    {
+        // a chain of ancestors in a tree can not be longer than the amount of vertices
+        if (++steps > graph->verticesCount)
+        {
+            return false;
+        }
+
+        currentVertex = graph->listOfAncestors[rootIndex];
+        rootIndex = currentVertex->vertexKey;
+    }
+    graph->root = rootIndex;
+    return true;
+}
+
+/**
+ * @brief Get the degree of a given vertex in a graph
+ * @param graph
+ * @param vertexKey
+ * */
+int getVertexDeg(Graph *graph, int vertexKey)
+{
+
+    Vertex *vertexPtr = graph->listOfAdjacent[vertexKey];
+    int deg = 0;
+
+    while (vertexPtr)
+    {
+        deg++;
+
+        vertexPtr = vertexPtr->next;
+    }
+    return deg;
+}
+
+/**
+ * @brief Add edges to the graph
+ * @param graph
+ * @param rows the parsed rows of the txt input
+ * */
+void attachEdges(Graph *graph, GraphRows *rows)
+{
+
+    int u;
+    int i;
+    int verticesCount = graph->verticesCount;
+
+    // attach the edges
+    for (u = 0; u < verticesCount; u++)
+    {
+        for (i = rows->offsets[u]; i < rows->offsets[u + 1]; i++)
+        {
+            addWeightedEdge(graph, u, rows->neighbors[i],
+                            (rows->weights != NULL) ? rows->weights[i] : DEFAULT_EDGE_WEIGHT);
+        }
+    }
+
+    graph->weighted = (rows->weights != NULL);
+}
+
+/**
+ * @brief Add edge between 2 vertices in a given graph
+ * @param graph
+ * @param uVertexIndex
+ * @param vVertexIndex
+ * */
+void addEdge(Graph *graph, int uVertexIndex, int vVertexIndex)
+{
+    addWeightedEdge(graph, uVertexIndex, vVertexIndex, DEFAULT_EDGE_WEIGHT);
+}
+
+/**
+ * @brief Add edge with a given weight between 2 vertices in a given graph
+ * @param graph
+ * @param uVertexIndex
+ * @param vVertexIndex
+ * @param weight
+ * */
+void addWeightedEdge(Graph *graph, int uVertexIndex, int vVertexIndex, int weight)
+{
+
+    // add the edge from u to v
+    Vertex *newVertex = createVertex(graph, vVertexIndex);
+    newVertex->weight = weight;
+    newVertex->next = graph->listOfAdjacent[uVertexIndex];
+    graph->listOfAdjacent[uVertexIndex] = newVertex;
+
+    // add the edge from v to u
+    newVertex = createVertex(graph, uVertexIndex);
+    newVertex->weight = weight;
+    newVertex->next = graph->listOfAdjacent[vVertexIndex];
+    graph->listOfAdjacent[vVertexIndex] = newVertex;
+
+    // save  the ancestors
+    graph->listOfAncestors[vVertexIndex] = newVertex;
+
+    // increase the edge count
+    graph->edgesCount = graph->edgesCount + 1;
+
+};
+
+
+/**
+ * @brief Find out whenver a graph is a tree. A graph with n vertices is a tree iff it has n-1 edges and it is
+ * connected, so a single traversal from the root is enough. Graphs parsed by parseGraphFile were already checked
+ * while they were read, and the traversal is the one finding their distances from the root. On success the root
+ * of the tree is set and the distances of the vertices from the root are stored in the analysis.
+ * @param graph
+ * @param analysis the buffers used for the traversal
+ * */
+bool isTree(Graph *graph, TreeAnalysis *analysis)
+{
+    double start;
+    bool rootFound;
+
+    if (graph->edgesCount != graph->verticesCount - 1)
+    {
+        return false;
+    }
+
+    // the root can only be found when the ancestors do not form a cycle
+    start = getSeconds();
+    rootFound = setRootVertexKey(graph);
+    recordPhase(analysis->diagnostics, "setRootVertexKey", start);
+    if (!rootFound)
+    {
+        return false;
+    }
+
+    return isConnected(graph, analysis);
+}
+
+/**
+ * @brief Find out whenver a graph is connected, by traversing it from its root
+ * @param graph
+ * @param analysis the buffers used for the traversal. Filled with the distances from the root
+ * */
+bool isConnected(Graph *graph, TreeAnalysis *analysis)
+{
+    // fill the distance array, the graph is connected when every vertex was reached
+    return traverseGraph(graph, analysis, graph->root, analysis->distFromRoot, analysis->parent) ==
+           graph->verticesCount;
+}
+
+/**
+ * @brief Traverses a graph from a given vertex. Large graphs are traversed by a parallel bfs when more than one
+ * thread is available, others by bfs
+ * @param graph
+ * @param analysis holds the buffers of the traversal
+ * @param startVertexKey the vertex to start the traversal from
+ * @param distFromVertex filled with the distance of every reached vertex from the start vertex. When NULL, the
+ * distances are kept in the workspace of the analysis until the next traversal
+ * @param traverseSource filled with the vertex from which every vertex was reached, -1 for the start vertex.
+ * When NULL, the sources are kept in the workspace of the analysis until the next traversal
+ * @return the amount of reached vertices
+ * */
+int traverseGraph(Graph *graph, TreeAnalysis *analysis, int startVertexKey, DistanceFromNode distFromVertex,
+                  int *traverseSource)
+{
+    if (analysis->diagnostics != NULL)
+    {
+        analysis->diagnostics->bfsPasses++;
+    }
+
+    if (distFromVertex == NULL)
+    {
+        distFromVertex = analysis->workspace->dist;
+    }
+    if (traverseSource == NULL)
+    {
+        traverseSource = analysis->workspace->parent;
+    }
+
+    if ((analysis->parallelBfs == NULL) && (graph->verticesCount >= PARALLEL_BFS_MIN_VERTICES))
+    {
+        if (analysis->threadCount == 0)
+        {
+            analysis->threadCount = getThreadCount();
+        }
+        if (analysis->threadCount > 1)
+        {
+            analysis->parallelBfs = initParallelBfs(graph, analysis->threadCount);
+        }
+    }
+
+    if (analysis->parallelBfs != NULL)
+    {
+        return parallelBfs(analysis->parallelBfs, startVertexKey, distFromVertex, traverseSource);
+    }
+
+    return bfs(graph, analysis->workspace, startVertexKey, distFromVertex, traverseSource);
+}
+
+/**
+ * @brief Initialize the buffers of bfs for a graph with a given size
+ * @param verticesCount
+ * */
+BfsWorkspace *initBfsWorkspace(int verticesCount)
+{
+    BfsWorkspace *workspace = malloc(sizeof(BfsWorkspace));
+
+    workspace->capacity = verticesCount;
+    workspace->queue = malloc(verticesCount * sizeof(int));
+    workspace->visitedGeneration = calloc(verticesCount, sizeof(unsigned int));
+    workspace->generation = 0;
+    workspace->dist = calloc(verticesCount, sizeof(int));
+    workspace->parent = malloc(verticesCount * sizeof(int));
+
+    return workspace;
+}
+
+/**
+ * @brief Release the memory allocated to the buffers of bfs
+ * @param workspacePtr
+ * */
+void freeBfsWorkspace(BfsWorkspace **workspacePtr)
+{
+    free((*workspacePtr)->queue);
+    free((*workspacePtr)->visitedGeneration);
+    free((*workspacePtr)->dist);
+    free((*workspacePtr)->parent);
+    free(*workspacePtr);
+    *workspacePtr = NULL;
+}
+
+/**
+ * @brief Starts a new generation of the visited stamps of a workspace, which marks every vertex as not visited.
+ * The stamps are only cleared when the generation wraps around
+ * @param workspace
+ * */
+void startBfsGeneration(BfsWorkspace *workspace)
+{
+    workspace->generation++;
+    if (workspace->generation == 0)
+    {
+        memset(workspace->visitedGeneration, 0, workspace->capacity * sizeof(unsigned int));
+        workspace->generation = 1;
+    }
+}
+
+/**
+ * @brief Performs bfs on a graph from a given vertex. Only the reached vertices are written, so a traversal costs
+ * nothing for the parts of the graph it does not reach
+ * @param graph
+ * @param workspace the buffers of the traversal
+ * @param startVertexKey the vertex to start the traversal from
+ * @param distFromVertex filled with the distance of every reached vertex from the start vertex
+ * @param traverseSource filled with the vertex from which every vertex was reached, -1 for the start vertex
+ * @return the amount of reached vertices
+ * */
+int bfs(Graph *graph, BfsWorkspace *workspace, int startVertexKey, DistanceFromNode distFromVertex,
+        int *traverseSource)
+{
+    int *queue = workspace->queue;
+    unsigned int *visitedGeneration = workspace->visitedGeneration;
+    int queueHead = 0;
+    int queueTail = 0;
+    int queueSize = 0;
+    int reachedCount = 1;
+    int adjVertex;
+    int currentVertex;
+    Vertex *temp;
+
+    startBfsGeneration(workspace);
+
+    visitedGeneration[startVertexKey] = workspace->generation;
+    distFromVertex[startVertexKey] = 0;
+    traverseSource[startVertexKey] = -1;
+    queue[queueTail] = startVertexKey;
+    queueTail = (queueTail + 1 == workspace->capacity) ? 0 : queueTail + 1;
+    queueSize++;
+
+    while (queueSize > 0)
+    {
+        currentVertex = queue[queueHead];
+        queueHead = (queueHead + 1 == workspace->capacity) ? 0 : queueHead + 1;
+        queueSize--;
+
+        temp = graph->listOfAdjacent[currentVertex];
+        while (temp)
+        {
+            adjVertex = temp->vertexKey;
+
+            if (visitedGeneration[adjVertex] != workspace->generation)
+            {
+                visitedGeneration[adjVertex] = workspace->generation;
+                distFromVertex[adjVertex] = distFromVertex[currentVertex] + 1;
+                traverseSource[adjVertex] = currentVertex;
+                reachedCount++;
+
+                queue[queueTail] = adjVertex;
+                queueTail = (queueTail + 1 == workspace->capacity) ? 0 : queueTail + 1;
+                queueSize++;
+            }
+
+            temp = temp->next;
+        }
+    }
+
+    return reachedCount;
+}
+
+/**
+ * @brief Initialize a Graph  struct with a given size
+ * @param verticesCount
+ * */
+Graph *initGraph(int verticesCount)
+{
+
+    Graph *graph = malloc(sizeof(Graph));
+    int i;
+
+    graph->verticesCount = verticesCount;
+    graph->listOfAdjacent = malloc(verticesCount * sizeof(Vertex *));
+    graph->listOfAncestors = malloc(verticesCount * sizeof(Vertex *));
+    graph->edgesCount = 0;
+    graph->root = 0;
+    graph->weighted = false;
+    graph->originalKeys = NULL;
+    initArena(&graph->arena);
+
+
+    for (i = 0; i < verticesCount; i++)
+    {
+        graph->listOfAdjacent[i] = NULL;
+        graph->listOfAncestors[i] = NULL;
+    }
+
+    return graph;
+}
+
+/**
+ * @brief Initialize a vertex struct with a given key value, allocated from the arena of the graph
+ * @param graph the graph the vertex is added to
+ * @param vertexKey
+ * */
+Vertex *createVertex(Graph *graph, int vertexKey)
+{
+
+    Vertex *newVertex = arenaAlloc(&graph->arena, sizeof(Vertex));
+    newVertex->vertexKey = vertexKey;
+    newVertex->weight = DEFAULT_EDGE_WEIGHT;
+    newVertex->next = NULL;
+
+    return newVertex;
+};
+
+
+/**
+ * @brief Initialize the buffers of a tree analysis for a graph with a given size
+ * @param verticesCount
+ * */
+TreeAnalysis *initTreeAnalysis(int verticesCount)
+{
+    TreeAnalysis *analysis = malloc(sizeof(TreeAnalysis));
+
+    analysis->distFromRoot = calloc(verticesCount, sizeof(int));
+    analysis->parent = malloc(verticesCount * sizeof(int));
+    analysis->scratch = malloc(verticesCount * sizeof(int));
+    analysis->workspace = initBfsWorkspace(verticesCount);
+    analysis->weightedDepth = NULL;
+    analysis->farthestFromRoot = 0;
+    analysis->minBranchLength = 0;
+    analysis->maxBranchLength = 0;
+    analysis->diameter = 0;
+    analysis->parallelBfs = NULL;
+    analysis->threadCount = 0;
+    analysis->diagnostics = NULL;
+
+    return analysis;
+}
+
+/**
+ * @brief Release the memory allocated to a given tree analysis
+ * @param analysisPtr
+ * */
+void freeTreeAnalysis(TreeAnalysis **analysisPtr)
+{
+    free((*analysisPtr)->distFromRoot);
+    free((*analysisPtr)->parent);
+    free((*analysisPtr)->scratch);
+    free((*analysisPtr)->weightedDepth);
+    freeBfsWorkspace(&(*analysisPtr)->workspace);
+    if ((*analysisPtr)->parallelBfs != NULL)
+    {
+        freeParallelBfs(&(*analysisPtr)->parallelBfs);
+    }
+    free(*analysisPtr);
+    *analysisPtr = NULL;
+}
+
+/**
+ * @brief Finds the diameter of a given tree. The farthest vertex from the root is an end of a diameter, so
+ * a single traversal from it is needed on top of the distances from the root.
+ * @param graph
+ * @param analysis an analysis that already holds the distances from the root
+ * */
+int findGraphDiameter(Graph *graph, TreeAnalysis *analysis)
+{
+    DistanceFromNode distFromEnd = analysis->workspace->dist;
+    int diameter = 0;
+    int vertexIndex;
+
+    // a single vertex is the farthest from itself
+    if (analysis->farthestFromRoot == graph->root)
+    {
+        return diameter;
+    }
+
+    // performs bfs to get the distances from the found leaf
+    traverseGraph(graph, analysis, analysis->farthestFromRoot, NULL, NULL);
+
+    // find the vertex with the maximal length from the found vertex
+    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    {
+        if (distFromEnd[vertexIndex] > diameter)
+        {
+            diameter = distFromEnd[vertexIndex];
+        }
+    }
+
+    return diameter;
+}
+
+/**
+ * @brief Finds the min and max branch lengths of a given tree in a single pass over its leaves
+ * @param graph
+ * @param analysis an analysis that already holds the distances from the root
+ * */
+void findBranchLengths(Graph *graph, TreeAnalysis *analysis)
+{
+    DistanceFromNode distanceFromNode = analysis->distFromRoot;
+    int minBranchLength = graph->verticesCount;
+    int maxBranchLength = 0;
+    int farthestFromRoot = graph->root;
+    int vertexIndex;
+
+    // goes over each leaf and find the ones with the minimal and maximal distance from the root
+    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    {
+        if (distanceFromNode[vertexIndex] > distanceFromNode[farthestFromRoot])
+        {
+            farthestFromRoot = vertexIndex;
+        }
+
+        // only leaves end a branch
+        if (getVertexDeg(graph, vertexIndex) != 1)
+        {
+            continue;
+        }
+
+        if (distanceFromNode[vertexIndex] > maxBranchLength)
+        {
+            maxBranchLength = distanceFromNode[vertexIndex];
+        }
+
+        if ((distanceFromNode[vertexIndex] < minBranchLength) && vertexIndex != graph->root)
+        {
+            minBranchLength = distanceFromNode[vertexIndex];
+        }
+    }
+
+    // case there is only vertex
+    if (graph->verticesCount == 1)
+    {
+        minBranchLength = 0;
+    }
+
+    analysis->farthestFromRoot = farthestFromRoot;
+    analysis->minBranchLength = minBranchLength;
+    analysis->maxBranchLength = maxBranchLength;
+}
+
+/**
+ * @brief Finds a given graph info regarding diameter,max branch length and min  branch length
+ * @param graph
+ * @param analysis an analysis that already holds the distances from the root
+ * */
+void findTreeDistanceInfo(Graph *graph, TreeAnalysis *analysis)
+{
+    double start = getSeconds();
+
+    if (graph->weighted)
+    {
+        findWeightedDistanceInfo(graph, analysis);
+        recordPhase(analysis->diagnostics, "findWeightedDistanceInfo", start);
+        return;
+    }
+
+    // find out the min/max branches length
+    findBranchLengths(graph, analysis);
+    recordPhase(analysis->diagnostics, "findBranchLengths", start);
+
+    // find out the diameter of the graph
+    start = getSeconds();
+    analysis->diameter = findGraphDiameter(graph, analysis);
+    recordPhase(analysis->diagnostics, "findGraphDiameter", start);
+}
+
+/**
+ * @brief Prints a given graph graph info regarding diameter,max branch length and min  branch length
+ * @param graph
+ * @param analysis an analysis that already holds the distances from the root
+ * */
+void printTreeDistanceInfo(Graph *graph, TreeAnalysis *analysis)
+{
+    findTreeDistanceInfo(graph, analysis);
+
+    // print the results to the terminal
+    printf("%s%lld\n", MINIMAL_BRACH_LENGTH_MSG, analysis->minBranchLength);
+    printf("%s%lld\n", MAXIMAL_BRACH_LENGTH_MSG, analysis->maxBranchLength);
+    printf("%s%lld\n", DIAMETER_LENGTH_MSG, analysis->diameter);
+}
+
+/**
+ * @brief Find the weighted distance of every vertex of a tree from a given vertex. Every vertex of a tree is reached
+ * by a single path, so a single traversal in any order sums the weights along it
+ * @param graph a tree
+ * @param workspace the buffers of the traversal. Its queue is used as a stack
+ * @param startVertexKey
+ * @param weightedDist filled with the sum of the weights on the path from the start vertex to every vertex
+ * @return a vertex with the maximal weighted distance from the start vertex
+ * */
+int findWeightedDistances(Graph *graph, BfsWorkspace *workspace, int startVertexKey, long long *weightedDist)
+{
+    int *stack = workspace->queue;
+    int stackSize = 0;
+    int farthest = startVertexKey;
+    int currentVertex;
+    Vertex *temp;
+
+    startBfsGeneration(workspace);
+
+    workspace->visitedGeneration[startVertexKey] = workspace->generation;
+    weightedDist[startVertexKey] = 0;
+    stack[stackSize++] = startVertexKey;
+
+    while (stackSize > 0)
+    {
+        currentVertex = stack[--stackSize];
+        if (weightedDist[currentVertex] > weightedDist[farthest])
+        {
+            farthest = currentVertex;
+        }
+
+        for (temp = graph->listOfAdjacent[currentVertex]; temp != NULL; temp = temp->next)
+        {
+            if (workspace->visitedGeneration[temp->vertexKey] != workspace->generation)
+            {
+                workspace->visitedGeneration[temp->vertexKey] = workspace->generation;
+                weightedDist[temp->vertexKey] = weightedDist[currentVertex] + temp->weight;
+                stack[stackSize++] = temp->vertexKey;
+            }
+        }
+    }
+
+    return farthest;
+}
+
+/**
+ * @brief Finds the diameter and the branch lengths of a weighted tree, as sums of weights. The weights are not
+ * negative, so as for unweighted trees the farthest vertex from the root is an end of a diameter, and two traversals
+ * are enough
+ * @param graph a weighted tree
+ * @param analysis an analysis of the tree, whose root is set
+ * */
+void findWeightedDistanceInfo(Graph *graph, TreeAnalysis *analysis)
+{
+    long long *weightedDepth;
+    long long *distFromEnd;
+    bool leafFound = false;
+    int farthest;
+    int vertexIndex;
+
+    // sized as the other buffers, so an analysis reused for a smaller tree can hold it
+    if (analysis->weightedDepth == NULL)
+    {
+        analysis->weightedDepth = malloc(analysis->workspace->capacity * sizeof(long long));
+    }
+    weightedDepth = analysis->weightedDepth;
+
+    // the sums of the weights from the root
+    farthest = findWeightedDistances(graph, analysis->workspace, graph->root, weightedDepth);
+
+    // goes over each leaf and find the ones with the minimal and maximal weighted distance from the root
+    analysis->minBranchLength = 0;
+    analysis->maxBranchLength = 0;
+    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    {
+        if ((vertexIndex == graph->root) || (getVertexDeg(graph, vertexIndex) != 1))
+        {
+            continue;
+        }
+
+        if (weightedDepth[vertexIndex] > analysis->maxBranchLength)
+        {
+            analysis->maxBranchLength = weightedDepth[vertexIndex];
+        }
+
+        if ((!leafFound) || (weightedDepth[vertexIndex] < analysis->minBranchLength))
+        {
+            analysis->minBranchLength = weightedDepth[vertexIndex];
+        }
+        leafFound = true;
+    }
+
+    // a second traversal from the end of a diameter
+    distFromEnd = malloc(graph->verticesCount * sizeof(long long));
+    analysis->farthestFromRoot = farthest;
+    farthest = findWeightedDistances(graph, analysis->workspace, farthest, distFromEnd);
+    analysis->diameter = distFromEnd[farthest];
+    free(distFromEnd);
+}
+
+/**
+ * @brief Find the weighted length of a path in a weighted tree, from the sums of the weights from the root to its
+ * ends and to its lowest common ancestor, which is the shallowest vertex of the path
+ * @param analysis an analysis that already holds the weighted distances from the root
+ * @param path the vertices of the path
+ * @param pathLength the amount of vertices in the path
+ * */
+long long findWeightedPathLength(TreeAnalysis *analysis, int *path, int pathLength)
+{
+    int lca = path[0];
+    int i;
+
+    for (i = 1; i < pathLength; i++)
+    {
+        if (analysis->distFromRoot[path[i]] < analysis->distFromRoot[lca])
+        {
+            lca = path[i];
+        }
+    }
+
+    return analysis->weightedDepth[path[0]] + analysis->weightedDepth[path[pathLength - 1]] -
+           2 * analysis->weightedDepth[lca];
+}
+
+/**
+ * @brief Find the shortest path between two vertices in a tree. The path is the only one in the tree, and it
+ * is found by climbing from both vertices towards the root until they meet.
+ * @param analysis an analysis that already holds the distances from the root and the traversal sources
+ * @param verticesCount the amount of vertices in the tree
+ * @param uVertexKey  the path start vertex
+ * @param vVertexKey the  path end vertex
+ * @param path filled with the vertices of the path, from u to v. Should hold the amount of vertices in the tree
+ * @return the amount of vertices in the path
+ * */
+int findShortestPath(TreeAnalysis *analysis, int verticesCount, int uVertexKey, int vVertexKey, int *path)
+{
+    DistanceFromNode depth = analysis->distFromRoot;
+    int currentVertexKey = uVertexKey;
+    int otherVertexKey = vVertexKey;
+    int pathLength = 0;
+    int stackSize = 0;
+
+    // climb from u while it is deeper than v, adding the path
+    while (depth[currentVertexKey] > depth[otherVertexKey])
+    {
+        path[pathLength++] = currentVertexKey;
+        currentVertexKey = analysis->parent[currentVertexKey];
+    }
+
+    // climb from v while it is deeper than u, saving the path backwards at the end of the array
+    while (depth[otherVertexKey] > depth[currentVertexKey])
+    {
+        path[verticesCount - ++stackSize] = otherVertexKey;
+        otherVertexKey = analysis->parent[otherVertexKey];
+    }
+
+    // climb from both until they meet
+    while (currentVertexKey != otherVertexKey)
+    {
+        path[pathLength++] = currentVertexKey;
+        currentVertexKey = analysis->parent[currentVertexKey];
+        path[verticesCount - ++stackSize] = otherVertexKey;
+        otherVertexKey = analysis->parent[otherVertexKey];
+    }
+
+    // add the meeting vertex and move the rest of the path after it
+    path[pathLength++] = currentVertexKey;
+    memmove(path + pathLength, path + verticesCount - stackSize, stackSize * sizeof(int));
+
+    return pathLength + stackSize;
+}
+
+/**
+ * @brief Prints the shortest path between two vertices in a tree, with the keys the vertices had in the input
+ * @param graph
+ * @param analysis an analysis that already holds the distances from the root and the traversal sources
+ * @param uVertexKey  the path start vertex
+ * @param vVertexKey the  path end vertex
+ * @return the amount of vertices in the path, which is left in the scratch buffer of the analysis
+ * */
+int printShortestPath(Graph *graph, TreeAnalysis *analysis, int uVertexKey, int vVertexKey)
+{
+    int pathLength = findShortestPath(analysis, graph->verticesCount, uVertexKey, vVertexKey, analysis->scratch);
+    int i;
+
+    // print the path to the terminal
+    printf("Shortest Path Between %d and %d:", getOriginalKey(graph, uVertexKey), getOriginalKey(graph, vVertexKey));
+    for (i = 0; i < pathLength; i++)
+    {
+        printf(" %d", getOriginalKey(graph, analysis->scratch[i]));
+    }
+
+    //  end the row
+    printf("\n");
+
+    return pathLength;
+};
+
+/**
+ * @brief Prints the full analysis for a graph
+ * @param graph
+ * @param analysis an analysis that already holds the distances from the root
+ * @param uVertexKey  the path start vertex
+ * @param vVertexKey the  path end vertex
+ * */
+void printTreeInfo(Graph *graph, TreeAnalysis *analysis, int uVertexKey, int vVertexKey)
+{
+    double start;
+    int pathLength;
+
+    // prints info of the root the graph
+    printf("%s%d\n", ROOT_VERTEX_MSG, getOriginalKey(graph, graph->root));
+
+    // Displays the total vertices number
+    printf("%s%d\n", VERTICES_COUNT_MSG, graph->verticesCount);
+
+    // Displays the total edges number
+    printf("%s%d\n", EDGES_COUNT_MSG, graph->edgesCount);
+
+    // prints info regarding the distance of the tree
+    printTreeDistanceInfo(graph, analysis);
+
+    // print the shortest path between the given vertex
+    start = getSeconds();
+    pathLength = printShortestPath(graph, analysis, uVertexKey, vVertexKey);
+    recordPhase(analysis->diagnostics, "printShortestPath", start);
+
+    // the length of the path is its amount of edges, unless the edges are weighted
+    if (graph->weighted)
+    {
+        printf("%s%lld\n", PATH_LENGTH_MSG, findWeightedPathLength(analysis, analysis->scratch, pathLength));
+    }
+};
+
+/**
+ * @brief Release the memory allocated to edges on a given graph. All of them are in the arena of the graph
+ * @param graphPtr
+ * */
+void deleteAllEdges(Graph **graphPtr)
+{
+    freeArena(&(*graphPtr)->arena);
+}
+
+/**
+ * @brief Release the memory allocated to a given graph
+ * @param graphPtr
+ * */
+void freeGraph(Graph **graphPtr)
+{
+
+    // deletes all the edges
+    deleteAllEdges(graphPtr);
+
+    // deletes the list of vertices
+    free((*graphPtr)->listOfAncestors);
+    free((*graphPtr)->listOfAdjacent);
+    free((*graphPtr)->originalKeys);
+
+    free((*graphPtr));
+
+}
+
+
+/**
+ * @brief Find whenever a number is contained in a given string
+ * @param str A given string
+ * */
+bool containsNumber(char *str)
+{
+    return nonNumerical(str) != ((int) strlen(str));
+}
+
+/**
+ * @brief Find the total non numerical characters in a given string
+ * @param str A given string
+ * @return total non numerical values
+ * */
+int nonNumerical(char *str)
+{
+    int i;
+    int length = (int) strlen(str);
+    int nonNumericalTotal = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        if (!isdigit(str[i]))
+        {
+            nonNumericalTotal++;
+        }
+
+    }
+
+    return nonNumericalTotal;
+}
+
+/**
+ * @brief Runs the additional mode selected by the first argument
+ * @param argc
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runMode(int argc, char *argv[])
+{
+    int modesCount = sizeof(ANALYZER_MODES) / sizeof(ANALYZER_MODES[0]);
+    int i;
+
+    for (i = 0; i < modesCount; i++)
+    {
+        if (strcmp(ANALYZER_MODES[i].flag, argv[MODE_FLAG_INDEX]) != 0)
+        {
+            continue;
+        }
+
+        // check the total amount of given arguments
+        if (argc != ANALYZER_MODES[i].argCount)
+        {
+            fprintf(stderr, "%s", ANALYZER_MODES[i].usage);
+            return EXIT_FAILURE;
+        }
+
+        return ANALYZER_MODES[i].run(argv);
+    }
+
+    fprintf(stderr, "%s", INVALID_USAGE_MSG);
+    return EXIT_FAILURE;
+}
+
+/**
+ * @brief Parses a graph file, builds the graph and checks it is a tree. Prints an error message on failure
+ * @param file the path of the graph file
+ * @param graphPtr set to the built graph on success
+ * @param analysisPtr set to an analysis holding the distances from the root on success
+ * */
+bool loadTree(char *file, Graph **graphPtr, TreeAnalysis **analysisPtr)
+{
+    if (!readGraph(file, 0, graphPtr, NULL, stderr))
+    {
+        return false;
+    }
+
+    *analysisPtr = initTreeAnalysis((*graphPtr)->verticesCount);
+    if (!isTree(*graphPtr, *analysisPtr))
+    {
+        fprintf(stderr, "%s", GRAPH_NOT_TREE_MSG);
+        freeTreeAnalysis(analysisPtr);
+        freeGraph(graphPtr);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Preprocess a tree for answering lowest common ancestor queries
+ * @param graph a tree whose root is set
+ * @param analysis an analysis that already holds the distances from the root and the traversal sources
+ * */
+TreeIndex *buildTreeIndex(Graph *graph, TreeAnalysis *analysis)
+{
+    TreeIndex *index = malloc(sizeof(TreeIndex));
+    int verticesCount = graph->verticesCount;
+
+    index->verticesCount = verticesCount;
+    index->root = graph->root;
+    index->mapping = NULL;
+    index->mappingSize = 0;
+
+    // the metrics of the default analysis are kept for the metrics query
+    findTreeDistanceInfo(graph, analysis);
+    index->edgesCount = graph->edgesCount;
+    index->minBranchLength = analysis->minBranchLength;
+    index->maxBranchLength = analysis->maxBranchLength;
+    index->diameter = analysis->diameter;
+
+    index->parent = malloc(verticesCount * sizeof(int));
+    index->depth = malloc(verticesCount * sizeof(int));
+    memcpy(index->parent, analysis->parent, verticesCount * sizeof(int));
+    memcpy(index->depth, analysis->distFromRoot, verticesCount * sizeof(int));
+    index->weightedDepth = NULL;
+    if (graph->weighted)
+    {
+        index->weightedDepth = malloc(verticesCount * sizeof(long long));
+        memcpy(index->weightedDepth, analysis->weightedDepth, verticesCount * sizeof(long long));
+    }
+
+    // every vertex is entered once, and returned to once after each of its children
+    index->tourLength = 2 * verticesCount - 1;
+    index->eulerTour = malloc(index->tourLength * sizeof(int));
+    index->firstVisit = malloc(verticesCount * sizeof(int));
+    index->entryTime = malloc(verticesCount * sizeof(int));
+    index->exitTime = malloc(verticesCount * sizeof(int));
+    buildEulerTour(graph, index);
+
+    index->levels = floorLog2(index->tourLength) + 1;
+    index->sparseTable = malloc((size_t) index->levels * index->tourLength * sizeof(int));
+    buildSparseTable(index);
+
+    index->adjacencyOffsets = malloc((verticesCount + 1) * sizeof(int));
+    index->adjacency = malloc(2 * (size_t) graph->edgesCount * sizeof(int));
+    buildAdjacencyArrays(graph, index->adjacencyOffsets, index->adjacency);
+
+    return index;
+}
+
+/**
+ * @brief Copies the adjacency lists of a graph into contiguous arrays
+ * @param graph
+ * @param adjacencyOffsets filled with the offset of the neighbors of every vertex, and the total amount of them
+ * @param adjacency filled with the neighbors of all the vertices
+ * */
+void buildAdjacencyArrays(Graph *graph, int *adjacencyOffsets, int *adjacency)
+{
+    int offset = 0;
+    int vertexIndex;
+    Vertex *edge;
+
+    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    {
+        adjacencyOffsets[vertexIndex] = offset;
+        for (edge = graph->listOfAdjacent[vertexIndex]; edge != NULL; edge = edge->next)
+        {
+            adjacency[offset++] = edge->vertexKey;
+        }
+    }
+    adjacencyOffsets[graph->verticesCount] = offset;
+}
+
+/**
+ * @brief Fills the euler tour of a tree and the entry and exit times of its vertices with an iterative dfs, so deep
+ * trees do not overflow the stack. The subtree of a vertex is the range of its entry and exit times
+ * @param graph a tree whose root is set
+ * @param index an index with its parent array set
+ * */
+void buildEulerTour(Graph *graph, TreeIndex *index)
+{
+    int *stack = malloc(graph->verticesCount * sizeof(int));
+    Vertex **nextEdge = malloc(graph->verticesCount * sizeof(Vertex *));
+    int stackSize = 0;
+    int tourLength = 0;
+    int enteredCount = 0;
+    int currentVertex, child;
+    Vertex *edge;
+
+    // enter the root
+    stack[stackSize++] = graph->root;
+    nextEdge[graph->root] = graph->listOfAdjacent[graph->root];
+    index->firstVisit[graph->root] = tourLength;
+    index->eulerTour[tourLength++] = graph->root;
+    index->entryTime[graph->root] = enteredCount++;
+
+    while (stackSize > 0)
+    {
+        currentVertex = stack[stackSize - 1];
+        edge = nextEdge[currentVertex];
+
+        // skip the edge leading back to the parent
+        if ((edge != NULL) && (edge->vertexKey == index->parent[currentVertex]))
+        {
+            edge = edge->next;
+        }
+
+        // enter the next child
+        if (edge != NULL)
+        {
+            nextEdge[currentVertex] = edge->next;
+            child = edge->vertexKey;
+            nextEdge[child] = graph->listOfAdjacent[child];
+            index->firstVisit[child] = tourLength;
+            index->eulerTour[tourLength++] = child;
+            index->entryTime[child] = enteredCount++;
+            stack[stackSize++] = child;
+            continue;
+        }
+
+        // all the children were visited, return to the parent
+        index->exitTime[currentVertex] = enteredCount - 1;
+        stackSize--;
+        if (stackSize > 0)
+        {
+            index->eulerTour[tourLength++] = stack[stackSize - 1];
+        }
+    }
+
+    free(stack);
+    free(nextEdge);
+}
+
+/**
+ * @brief Fills the sparse table of an index, each level is built from the previous one
+ * @param index an index with its euler tour set
+ * */
+void buildSparseTable(TreeIndex *index)
+{
+    int tourLength = index->tourLength;
+    int *previousLevel;
+    int *currentLevel;
+    int level, i, half;
+
+    memcpy(index->sparseTable, index->eulerTour, tourLength * sizeof(int));
+
+    for (level = 1; level < index->levels; level++)
+    {
+        previousLevel = index->sparseTable + (size_t) (level - 1) * tourLength;
+        currentLevel = index->sparseTable + (size_t) level * tourLength;
+        half = 1 << (level - 1);
+
+        // the range of length 2^level starting at i is made of two ranges of length 2^(level-1)
+        for (i = 0; i + 2 * half <= tourLength; i++)
+        {
+            currentLevel[i] = (index->depth[previousLevel[i]] <= index->depth[previousLevel[i + half]]) ?
+                              previousLevel[i] : previousLevel[i + half];
+        }
+    }
+}
+
+/**
+ * @brief Release the memory allocated to a given tree index
+ * @param indexPtr
+ * */
+void freeTreeIndex(TreeIndex **indexPtr)
+{
+    // the arrays of a mapped index are released with the mapping
+    if ((*indexPtr)->mapping != NULL)
+    {
+        munmap((*indexPtr)->mapping, (*indexPtr)->mappingSize);
+        free(*indexPtr);
+        *indexPtr = NULL;
+        return;
+    }
+
+    free((*indexPtr)->parent);
+    free((*indexPtr)->depth);
+    free((*indexPtr)->weightedDepth);
+    free((*indexPtr)->eulerTour);
+    free((*indexPtr)->firstVisit);
+    free((*indexPtr)->sparseTable);
+    free((*indexPtr)->entryTime);
+    free((*indexPtr)->exitTime);
+    free((*indexPtr)->adjacencyOffsets);
+    free((*indexPtr)->adjacency);
+    free(*indexPtr);
+    *indexPtr = NULL;
+}
+
+/**
+ * @brief Find the floor of the base 2 logarithm of a positive number
+ * @param value
+ * */
+int floorLog2(unsigned int value)
+{
+    return (int) (sizeof(unsigned int) * 8 - 1) - __builtin_clz(value);
+}
+
+/**
+ * @brief Find the lowest common ancestor of two vertices in O(1)
+ * @param index
+ * @param uVertexKey
+ * @param vVertexKey
+ * */
+int findLca(TreeIndex *index, int uVertexKey, int vVertexKey)
+{
+    int left = index->firstVisit[uVertexKey];
+    int right = index->firstVisit[vVertexKey];
+    int temp, level;
+    int *levelRow;
+
+    if (left > right)
+    {
+        temp = left;
+        left = right;
+        right = temp;
+    }
+
+    // the range is covered by two overlapping ranges whose length is a power of 2
+    level = floorLog2(right - left + 1);
+    levelRow = index->sparseTable + (size_t) level * index->tourLength;
+    right = right - (1 << level) + 1;
+
+    return (index->depth[levelRow[left]] <= index->depth[levelRow[right]]) ? levelRow[left] : levelRow[right];
+}
+
+/**
+ * @brief Find the length of the path between two vertices in O(1). The length of a path in a weighted tree is
+ * the sum of its weights, found from the sums of the weights from the root
+ * @param index
+ * @param uVertexKey
+ * @param vVertexKey
+ * */
+long long findTreeDistance(TreeIndex *index, int uVertexKey, int vVertexKey)
+{
+    int lca = findLca(index, uVertexKey, vVertexKey);
+
+    if (index->weightedDepth != NULL)
+    {
+        return index->weightedDepth[uVertexKey] + index->weightedDepth[vVertexKey] - 2 * index->weightedDepth[lca];
+    }
+
+    return index->depth[uVertexKey] + index->depth[vVertexKey] - 2 * index->depth[lca];
+}
+
+/**
+ * @brief Prints the path between two vertices in the same format as printShortestPath
+ * @param engine
+ * @param uVertexKey  the path start vertex
+ * @param vVertexKey the  path end vertex
+ * @param out the stream to print to
+ * */
+void printTreePath(QueryEngine *engine, int uVertexKey, int vVertexKey, FILE *out)
+{
+    TreeIndex *index = engine->index;
+    int lca = findLca(index, uVertexKey, vVertexKey);
+    int currentVertexKey;
+    int stackSize = 0;
+
+    fprintf(out, "Shortest Path Between %d and %d:", uVertexKey, vVertexKey);
+
+    // climb from u to the common ancestor
+    for (currentVertexKey = uVertexKey; currentVertexKey != lca; currentVertexKey = index->parent[currentVertexKey])
+    {
+        fprintf(out, " %d", currentVertexKey);
+    }
+    fprintf(out, " %d", lca);
+
+    // climb from v to the common ancestor, and print it backwards
+    for (currentVertexKey = vVertexKey; currentVertexKey != lca; currentVertexKey = index->parent[currentVertexKey])
+    {
+        engine->scratch[stackSize++] = currentVertexKey;
+    }
+    while (stackSize > 0)
+    {
+        fprintf(out, " %d", engine->scratch[--stackSize]);
+    }
+
+    fprintf(out, "\n");
+}
+
+/**
+ * @brief Answers "path u v" by printing the path between u and v
+ * @param engine
+ * @param args the vertices u and v
+ * @param out the stream to print to
+ * */
+bool queryPath(QueryEngine *engine, long *args, FILE *out)
+{
+    printTreePath(engine, (int) args[0], (int) args[1], out);
+    return true;
+}
+
+/**
+ * @brief Answers "distance u v" by printing the length of the path between u and v
+ * @param engine
+ * @param args the vertices u and v
+ * @param out the stream to print to
+ * */
+bool queryDistance(QueryEngine *engine, long *args, FILE *out)
+{
+    fprintf(out, "Distance Between %ld and %ld: %lld\n", args[0], args[1],
+            findTreeDistance(engine->index, (int) args[0], (int) args[1]));
+    return true;
+}
+
+/**
+ * @brief Answers "lca u v" by printing the lowest common ancestor of u and v
+ * @param engine
+ * @param args the vertices u and v
+ * @param out the stream to print to
+ * */
+bool queryLca(QueryEngine *engine, long *args, FILE *out)
+{
+    fprintf(out, "Lowest Common Ancestor of %ld and %ld: %d\n", args[0], args[1],
+            findLca(engine->index, (int) args[0], (int) args[1]));
+    return true;
+}
+
+/**
+ * @brief Find out whenever a vertex is an ancestor of another vertex, or the vertex itself, in O(1)
+ * @param index
+ * @param uVertexKey the ancestor
+ * @param vVertexKey
+ * */
+bool isAncestor(TreeIndex *index, int uVertexKey, int vVertexKey)
+{
+    return (index->entryTime[uVertexKey] <= index->entryTime[vVertexKey]) &&
+           (index->entryTime[vVertexKey] <= index->exitTime[uVertexKey]);
+}
+
+/**
+ * @brief Decomposes an indexed tree into heavy paths in O(n), with all the weights 0. The subtree sizes are known
+ * from the entry and exit times of the index
+ * @param index
+ * */
+PathDecomposition *initPathDecomposition(TreeIndex *index)
+{
+    PathDecomposition *paths = malloc(sizeof(PathDecomposition));
+    int verticesCount = index->verticesCount;
+    int *stack = malloc(verticesCount * sizeof(int));
+    int stackSize = 0;
+    int nextPosition = 0;
+    int vertexKey, child, heavyChild, edge;
+
+    paths->verticesCount = verticesCount;
+    paths->position = malloc(verticesCount * sizeof(int));
+    paths->head = malloc(verticesCount * sizeof(int));
+    paths->leavesCount = 1;
+    while (paths->leavesCount < verticesCount)
+    {
+        paths->leavesCount *= 2;
+    }
+    paths->sums = calloc(2 * paths->leavesCount, sizeof(long long));
+    paths->maxima = calloc(2 * paths->leavesCount, sizeof(long long));
+    paths->pending = calloc(2 * paths->leavesCount, sizeof(long long));
+
+    // the heavy child is pushed last, so it is placed right after its parent
+    paths->head[index->root] = index->root;
+    stack[stackSize++] = index->root;
+    while (stackSize > 0)
+    {
+        vertexKey = stack[--stackSize];
+        paths->position[vertexKey] = nextPosition++;
+
+        heavyChild = -1;
+        for (edge = index->adjacencyOffsets[vertexKey]; edge < index->adjacencyOffsets[vertexKey + 1]; edge++)
+        {
+            child = index->adjacency[edge];
+            if ((child != index->parent[vertexKey]) &&
+                ((heavyChild == -1) || (index->exitTime[child] - index->entryTime[child] >
+                                        index->exitTime[heavyChild] - index->entryTime[heavyChild])))
+            {
+                heavyChild = child;
+            }
+        }
+
+        for (edge = index->adjacencyOffsets[vertexKey]; edge < index->adjacencyOffsets[vertexKey + 1]; edge++)
+        {
+            child = index->adjacency[edge];
+            if ((child != index->parent[vertexKey]) && (child != heavyChild))
+            {
+                paths->head[child] = child;
+                stack[stackSize++] = child;
+            }
+        }
+        if (heavyChild != -1)
+        {
+            paths->head[heavyChild] = paths->head[vertexKey];
+            stack[stackSize++] = heavyChild;
+        }
+    }
+
+    free(stack);
+    return paths;
+}
+
+/**
+ * @brief Frees the weights of the vertices of a tree
+ * @param pathsPtr the weights, or a pointer to NULL when no weight was added
+ * */
+void freePathDecomposition(PathDecomposition **pathsPtr)
+{
+    PathDecomposition *paths = *pathsPtr;
+
+    if (paths == NULL)
+    {
+        return;
+    }
+
+    free(paths->position);
+    free(paths->head);
+    free(paths->sums);
+    free(paths->maxima);
+    free(paths->pending);
+    free(paths);
+    *pathsPtr = NULL;
+}
+
+/**
+ * @brief Passes the weight pending on a node of the segment tree to its two children
+ * @param paths
+ * @param node
+ * @param rangeLength the length of the range of each of the children
+ * */
+void pushPendingWeight(PathDecomposition *paths, int node, int rangeLength)
+{
+    long long weight = paths->pending[node];
+    int child;
+
+    if (weight == 0)
+    {
+        return;
+    }
+
+    for (child = 2 * node; child <= 2 * node + 1; child++)
+    {
+        paths->sums[child] += weight * rangeLength;
+        paths->maxima[child] += weight;
+        paths->pending[child] += weight;
+    }
+    paths->pending[node] = 0;
+}
+
+/**
+ * @brief Adds a weight to every place in a range, in O(log n)
+ * @param paths
+ * @param node the node of the segment tree to update
+ * @param nodeStart the first place in the range of the node
+ * @param nodeEnd the last place in the range of the node
+ * @param start the first place to add to
+ * @param end the last place to add to
+ * @param weight
+ * */
+void addRangeWeight(PathDecomposition *paths, int node, int nodeStart, int nodeEnd, int start, int end,
+                    long long weight)
+{
+    int middle = nodeStart + (nodeEnd - nodeStart) / 2;
+
+    if ((end < nodeStart) || (nodeEnd < start))
+    {
+        return;
+    }
+
+    // a node inside the range keeps the weight until one of its children is visited
+    if ((start <= nodeStart) && (nodeEnd <= end))
+    {
+        paths->sums[node] += weight * (nodeEnd - nodeStart + 1);
+        paths->maxima[node] += weight;
+        paths->pending[node] += weight;
+        return;
+    }
+
+    pushPendingWeight(paths, node, middle - nodeStart + 1);
+    addRangeWeight(paths, 2 * node, nodeStart, middle, start, end, weight);
+    addRangeWeight(paths, 2 * node + 1, middle + 1, nodeEnd, start, end, weight);
+    paths->sums[node] = paths->sums[2 * node] + paths->sums[2 * node + 1];
+    paths->maxima[node] = (paths->maxima[2 * node] > paths->maxima[2 * node + 1]) ? paths->maxima[2 * node] :
+                          paths->maxima[2 * node + 1];
+}
+
+/**
+ * @brief Find the total and the largest weight in a range of places, in O(log n)
+ * @param paths
+ * @param node the node of the segment tree to search
+ * @param nodeStart the first place in the range of the node
+ * @param nodeEnd the last place in the range of the node
+ * @param start the first place of the range
+ * @param end the last place of the range
+ * @param sum the weights in the range are added to it
+ * @param max raised to the largest weight in the range
+ * */
+void findRangeWeights(PathDecomposition *paths, int node, int nodeStart, int nodeEnd, int start, int end,
+                      long long *sum, long long *max)
+{
+    int middle = nodeStart + (nodeEnd - nodeStart) / 2;
+
+    if ((end < nodeStart) || (nodeEnd < start))
+    {
+        return;
+    }
+
+    if ((start <= nodeStart) && (nodeEnd <= end))
+    {
+        *sum += paths->sums[node];
+        if (paths->maxima[node] > *max)
+        {
+            *max = paths->maxima[node];
+        }
+        return;
+    }
+
+    pushPendingWeight(paths, node, middle - nodeStart + 1);
+    findRangeWeights(paths, 2 * node, nodeStart, middle, start, end, sum, max);
+    findRangeWeights(paths, 2 * node + 1, middle + 1, nodeEnd, start, end, sum, max);
+}
+
+/**
+ * @brief Adds a weight to every vertex on the path between two vertices, including both of them, in O(log^2 n):
+ * the path is climbed a heavy path at a time, from the end whose heavy path starts deeper
+ * @param engine
+ * @param uVertexKey
+ * @param vVertexKey
+ * @param weight
+ * */
+void addPathWeight(QueryEngine *engine, int uVertexKey, int vVertexKey, long long weight)
+{
+    TreeIndex *index = engine->index;
+    PathDecomposition *paths;
+    int temp;
+
+    if (engine->paths == NULL)
+    {
+        engine->paths = initPathDecomposition(index);
+    }
+    paths = engine->paths;
+
+    while (paths->head[uVertexKey] != paths->head[vVertexKey])
+    {
+        if (index->depth[paths->head[uVertexKey]] < index->depth[paths->head[vVertexKey]])
+        {
+            temp = uVertexKey;
+            uVertexKey = vVertexKey;
+            vVertexKey = temp;
+        }
+
+        addRangeWeight(paths, 1, 0, paths->leavesCount - 1, paths->position[paths->head[uVertexKey]],
+                       paths->position[uVertexKey], weight);
+        uVertexKey = index->parent[paths->head[uVertexKey]];
+    }
+
+    // both vertices are on the same heavy path, the higher one is placed first
+    if (paths->position[uVertexKey] > paths->position[vVertexKey])
+    {
+        temp = uVertexKey;
+        uVertexKey = vVertexKey;
+        vVertexKey = temp;
+    }
+    addRangeWeight(paths, 1, 0, paths->leavesCount - 1, paths->position[uVertexKey], paths->position[vVertexKey],
+                   weight);
+}
+
+/**
+ * @brief Find the total and the largest weight of the vertices on the path between two vertices, including both
+ * of them, in O(log^2 n)
+ * @param engine
+ * @param uVertexKey
+ * @param vVertexKey
+ * @param sum set to the total weight of the path
+ * @param max set to the largest weight on the path
+ * */
+void findPathWeights(QueryEngine *engine, int uVertexKey, int vVertexKey, long long *sum, long long *max)
+{
+    TreeIndex *index = engine->index;
+    PathDecomposition *paths = engine->paths;
+    int temp;
+
+    *sum = 0;
+    *max = LLONG_MIN;
+
+    // every vertex still has the weight 0
+    if (paths == NULL)
+    {
+        *max = 0;
+        return;
+    }
+
+    while (paths->head[uVertexKey] != paths->head[vVertexKey])
+    {
+        if (index->depth[paths->head[uVertexKey]] < index->depth[paths->head[vVertexKey]])
+        {
+            temp = uVertexKey;
+            uVertexKey = vVertexKey;
+            vVertexKey = temp;
+        }
+
+        findRangeWeights(paths, 1, 0, paths->leavesCount - 1, paths->position[paths->head[uVertexKey]],
+                         paths->position[uVertexKey], sum, max);
+        uVertexKey = index->parent[paths->head[uVertexKey]];
+    }
+
+    if (paths->position[uVertexKey] > paths->position[vVertexKey])
+    {
+        temp = uVertexKey;
+        uVertexKey = vVertexKey;
+        vVertexKey = temp;
+    }
+    findRangeWeights(paths, 1, 0, paths->leavesCount - 1, paths->position[uVertexKey], paths->position[vVertexKey],
+                     sum, max);
+}
+
+/**
+ * @brief Answers "subtree-size v" by printing the amount of vertices in the subtree of v
+ * @param engine
+ * @param args the vertex v
+ * @param out the stream to print to
+ * */
+bool querySubtreeSize(QueryEngine *engine, long *args, FILE *out)
+{
+    int vertexKey = (int) args[0];
+
+    fprintf(out, "Subtree Size of %d: %d\n", vertexKey,
+            engine->index->exitTime[vertexKey] - engine->index->entryTime[vertexKey] + 1);
+    return true;
+}
+
+/**
+ * @brief Answers "is-ancestor u v" by printing whenever u is an ancestor of v. A vertex is an ancestor of itself
+ * @param engine
+ * @param args the vertices u and v
+ * @param out the stream to print to
+ * */
+bool queryIsAncestor(QueryEngine *engine, long *args, FILE *out)
+{
+    fprintf(out, "Is %ld Ancestor of %ld: %s\n", args[0], args[1],
+            isAncestor(engine->index, (int) args[0], (int) args[1]) ? "Yes" : "No");
+    return true;
+}
+
+/**
+ * @brief Answers "add-weight v w" by adding w to the weight of v. Every vertex starts with the weight 0.
+ * Nothing is printed
+ * @param engine
+ * @param args the vertex v and the weight w
+ * @param out unused
+ * */
+bool queryAddWeight(QueryEngine *engine, long *args, FILE *out)
+{
+    (void) out;
+    addPathWeight(engine, (int) args[0], (int) args[0], args[1]);
+    return true;
+}
+
+/**
+ * @brief Answers "subtree-sum v" by printing the total weight of the vertices in the subtree of v
+ * @param engine
+ * @param args the vertex v
+ * @param out the stream to print to
+ * */
+bool querySubtreeSum(QueryEngine *engine, long *args, FILE *out)
+{
+    int vertexKey = (int) args[0];
+    long long sum = 0;
+    long long max = 0;
+    int start;
+
+    // the subtree is the range of places starting at the vertex
+    if (engine->paths != NULL)
+    {
+        start = engine->paths->position[vertexKey];
+        findRangeWeights(engine->paths, 1, 0, engine->paths->leavesCount - 1, start,
+                         start + engine->index->exitTime[vertexKey] - engine->index->entryTime[vertexKey], &sum, &max);
+    }
+
+    fprintf(out, "Subtree Sum of %d: %lld\n", vertexKey, sum);
+    return true;
+}
+
+/**
+ * @brief Answers "path-sum u v" by printing the total weight of the vertices on the path between u and v
+ * @param engine
+ * @param args the vertices u and v
+ * @param out the stream to print to
+ * */
+bool queryPathSum(QueryEngine *engine, long *args, FILE *out)
+{
+    long long sum, max;
+
+    findPathWeights(engine, (int) args[0], (int) args[1], &sum, &max);
+    fprintf(out, "Path Sum Between %ld and %ld: %lld\n", args[0], args[1], sum);
+    return true;
+}
+
+/**
+ * @brief Answers "path-max u v" by printing the largest weight of a vertex on the path between u and v
+ * @param engine
+ * @param args the vertices u and v
+ * @param out the stream to print to
+ * */
+bool queryPathMax(QueryEngine *engine, long *args, FILE *out)
+{
+    long long sum, max;
+
+    findPathWeights(engine, (int) args[0], (int) args[1], &sum, &max);
+    fprintf(out, "Path Max Between %ld and %ld: %lld\n", args[0], args[1], max);
+    return true;
+}
+
+/**
+ * @brief Answers "path-add u v w" by adding w to the weight of every vertex on the path between u and v.
+ * Nothing is printed
+ * @param engine
+ * @param args the vertices u and v and the weight w
+ * @param out unused
+ * */
+bool queryPathAdd(QueryEngine *engine, long *args, FILE *out)
+{
+    (void) out;
+    addPathWeight(engine, (int) args[0], (int) args[1], args[2]);
+    return true;
+}
+
+/**
+ * @brief Initialize the state needed for answering queries on a given index
+ * @param engine
+ * @param index
+ * */
+void initQueryEngine(QueryEngine *engine, TreeIndex *index)
+{
+    engine->index = index;
+    engine->scratch = malloc(index->verticesCount * sizeof(int));
+    engine->paths = NULL;
+}
+
+/**
+ * @brief Release the memory allocated to a query engine and to its index
+ * @param engine
+ * */
+void freeQueryEngine(QueryEngine *engine)
+{
+    free(engine->scratch);
+    freePathDecomposition(&engine->paths);
+    freeTreeIndex(&engine->index);
+}
+
+/**
+ * @brief Parses a single line of the form "<query name> <arguments>" and answers it. Empty lines are ignored
+ * @param engine
+ * @param line
+ * @param out the stream to print the answer to
+ * @return false when the line is not a valid query
+ * */
+bool executeQuery(QueryEngine *engine, char *line, FILE *out)
+{
+    int queriesCount = sizeof(TREE_QUERIES) / sizeof(TREE_QUERIES[0]);
+    char name[QUERY_NAME_LENGTH];
+    long args[QUERY_MAX_ARGS];
+    char *nextNumber;
+    char *end;
+    int nameLength = 0;
+    int argCount = 0;
+    int i;
+
+    // read the query name
+    if (sscanf(line, "%31s%n", name, &nameLength) != 1)
+    {
+        return true;
+    }
+
+    // read the numerical arguments
+    nextNumber = line + nameLength;
+    while (true)
+    {
+        // skip the separating spaces
+        nextNumber += strspn(nextNumber, " ");
+        if (*nextNumber == '\0')
+        {
+            break;
+        }
+
+        if (argCount == QUERY_MAX_ARGS)
+        {
+            return false;
+        }
+
+        args[argCount] = strtol(nextNumber, &end, 10);
+        if ((end == nextNumber) || ((*end != ' ') && (*end != '\0')))
+        {
+            return false;
+        }
+
+        argCount++;
+        nextNumber = end;
+    }
+
+    for (i = 0; i < queriesCount; i++)
+    {
+        if (strcmp(TREE_QUERIES[i].name, name) != 0)
+        {
+            continue;
+        }
+
+        if (argCount != TREE_QUERIES[i].argCount)
+        {
+            return false;
+        }
+
+        // check whenever the vertices are in the tree
+        for (argCount = 0; argCount < TREE_QUERIES[i].vertexArgCount; argCount++)
+        {
+            if ((args[argCount] < 0) || (args[argCount] >= engine->index->verticesCount))
+            {
+                return false;
+            }
+        }
+
+        return TREE_QUERIES[i].run(engine, args, out);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Answers every query in a queries file, one query per line
+ * @param engine
+ * @param file the path of the queries file
+ * @param out the stream to print the answers to
+ * @return false when the file can not be read or contains an invalid query. An error message is printed
+ * */
+bool runQueryFile(QueryEngine *engine, char *file, FILE *out)
+{
+    FILE *fp;
+    char line[MAX_ROW_LENGTH + 1];
+
+    fp = fopen(file, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "%s", QUERY_USAGE_MSG);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        // remove line terminators
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (!executeQuery(engine, line, out))
+        {
+            fprintf(stderr, "%s", INVALID_QUERY_MSG);
+            fclose(fp);
+            return false;
+        }
+    }
+
+    fclose(fp);
+    return true;
+}
+
+/**
+ * @brief Loads a tree once, preprocess it and answers every query in a queries file.
+ * Expects the arguments --query <Graph File Path> <Queries File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runQueryMode(char *argv[])
+{
+    Graph *graph;
+    TreeAnalysis *analysis;
+    QueryEngine engine;
+    bool success;
+
+    if (!loadTree(argv[MODE_FIRST_ARG_INDEX], &graph, &analysis))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // only the index is needed for answering the queries
+    initQueryEngine(&engine, buildTreeIndex(graph, analysis));
+    freeTreeAnalysis(&analysis);
+    freeGraph(&graph);
+
+    success = runQueryFile(&engine, argv[MODE_SECOND_ARG_INDEX], stdout);
+
+    freeQueryEngine(&engine);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Find the size of the arrays following a given index header in an index file
+ * @param header
+ * */
+size_t getIndexArraysSize(IndexHeader *header)
+{
+    size_t intCount = 0;
+
+    // parent, depth, and the offsets of the adjacency arrays
+    intCount += 3 * (size_t) header->verticesCount + 1;
+
+    // adjacency, every edge appears twice
+    intCount += 2 * (size_t) header->edgesCount;
+
+    // firstVisit, eulerTour and sparseTable
+    intCount += (size_t) header->verticesCount + header->tourLength;
+    intCount += (size_t) header->levels * header->tourLength;
+
+    // entryTime and exitTime
+    intCount += 2 * (size_t) header->verticesCount;
+
+    // weightedDepth
+    if (header->weighted)
+    {
+        return intCount * sizeof(int) + header->verticesCount * sizeof(long long);
+    }
+
+    return intCount * sizeof(int);
+}
+
+/**
+ * @brief Writes an index to a file, so it can be mapped by later runs instead of parsing the graph again
+ * @param index
+ * @param file the path of the index file
+ * @return false when the file could not be written
+ * */
+bool writeTreeIndex(TreeIndex *index, char *file)
+{
+    IndexHeader header;
+    FILE *fp;
+    bool success = true;
+    size_t verticesCount = index->verticesCount;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.verticesCount = index->verticesCount;
+    header.root = index->root;
+    header.edgesCount = index->edgesCount;
+    header.weighted = (index->weightedDepth != NULL);
+    header.minBranchLength = index->minBranchLength;
+    header.maxBranchLength = index->maxBranchLength;
+    header.diameter = index->diameter;
+    header.tourLength = index->tourLength;
+    header.levels = index->levels;
+
+    fp = fopen(file, "wb");
+    if (fp == NULL)
+    {
+        return false;
+    }
+
+    // the arrays are written in the order documented in IndexHeader
+    success = success && (fwrite(&header, sizeof(header), 1, fp) == 1);
+    if (header.weighted)
+    {
+        success = success && (fwrite(index->weightedDepth, sizeof(long long), verticesCount, fp) == verticesCount);
+    }
+    success = success && (fwrite(index->parent, sizeof(int), verticesCount, fp) == verticesCount);
+    success = success && (fwrite(index->depth, sizeof(int), verticesCount, fp) == verticesCount);
+    success = success && (fwrite(index->adjacencyOffsets, sizeof(int), verticesCount + 1, fp) == verticesCount + 1);
+    success = success && (fwrite(index->adjacency, sizeof(int), 2 * (size_t) index->edgesCount, fp) ==
+                          2 * (size_t) index->edgesCount);
+    success = success && (fwrite(index->firstVisit, sizeof(int), verticesCount, fp) == verticesCount);
+    success = success && (fwrite(index->eulerTour, sizeof(int), index->tourLength, fp) ==
+                          (size_t) index->tourLength);
+    success = success && (fwrite(index->sparseTable, sizeof(int), (size_t) index->levels * index->tourLength, fp) ==
+                          (size_t) index->levels * index->tourLength);
+    success = success && (fwrite(index->entryTime, sizeof(int), verticesCount, fp) == verticesCount);
+    success = success && (fwrite(index->exitTime, sizeof(int), verticesCount, fp) == verticesCount);
+
+    if (fclose(fp) != 0)
+    {
+        success = false;
+    }
+
+    return success;
+}
+
+/**
+ * @brief Maps an index file written by writeTreeIndex. The arrays of the index point into the mapping, so
+ * nothing is parsed or copied
+ * @param file the path of the index file
+ * @return the mapped index, or NULL when the file is not a valid index file
+ * */
+TreeIndex *mapTreeIndex(char *file)
+{
+    TreeIndex *index;
+    IndexHeader *header;
+    struct stat fileStat;
+    void *mapping;
+    int *nextArray;
+    int fd;
+
+    fd = open(file, O_RDONLY);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+
+    if ((fstat(fd, &fileStat) != 0) || ((size_t) fileStat.st_size < sizeof(IndexHeader)))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    // the mapping stays valid after the file is closed
+    mapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    // check the header describes the file
+    header = (IndexHeader *) mapping;
+    if ((memcmp(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) || (header->version != INDEX_VERSION) ||
+        (header->verticesCount <= 0) || (header->verticesCount > INT_MAX / 2) ||
+        (header->tourLength != 2 * header->verticesCount - 1) ||
+        (header->levels != floorLog2(header->tourLength) + 1) ||
+        (header->edgesCount != header->verticesCount - 1) ||
+        (header->root < 0) || (header->root >= header->verticesCount) ||
+        ((header->weighted != 0) && (header->weighted != 1)) ||
+        ((size_t) fileStat.st_size != sizeof(IndexHeader) + getIndexArraysSize(header)))
+    {
+        munmap(mapping, fileStat.st_size);
+        return NULL;
+    }
+
+    index = malloc(sizeof(TreeIndex));
+    index->mapping = mapping;
+    index->mappingSize = fileStat.st_size;
+    index->verticesCount = header->verticesCount;
+    index->root = header->root;
+    index->edgesCount = header->edgesCount;
+    index->minBranchLength = header->minBranchLength;
+    index->maxBranchLength = header->maxBranchLength;
+    index->diameter = header->diameter;
+    index->tourLength = header->tourLength;
+    index->levels = header->levels;
+
+    // point the arrays into the mapping, in the order documented in IndexHeader
+    index->weightedDepth = NULL;
+    nextArray = (int *) (header + 1);
+    if (header->weighted)
+    {
+        index->weightedDepth = (long long *) nextArray;
+        nextArray = (int *) (index->weightedDepth + index->verticesCount);
+    }
+    index->parent = nextArray;
+    nextArray += index->verticesCount;
+    index->depth = nextArray;
+    nextArray += index->verticesCount;
+    index->adjacencyOffsets = nextArray;
+    nextArray += index->verticesCount + 1;
+    index->adjacency = nextArray;
+    nextArray += 2 * (size_t) index->edgesCount;
+    index->firstVisit = nextArray;
+    nextArray += index->verticesCount;
+    index->eulerTour = nextArray;
+    nextArray += index->tourLength;
+    index->sparseTable = nextArray;
+    nextArray += (size_t) index->levels * index->tourLength;
+    index->entryTime = nextArray;
+    nextArray += index->verticesCount;
+    index->exitTime = nextArray;
+
+    // the queries index the arrays with their own contents, so a corrupted file is rejected here
+    if (!isValidTreeIndex(index))
+    {
+        munmap(mapping, fileStat.st_size);
+        free(index);
+        return NULL;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Checks the arrays of a mapped index describe the tree in its header, the way buildTreeIndex fills them:
+ * every parent is one level above its child, the adjacency arrays hold exactly the parent and the children of
+ * every vertex, the euler tour is a dfs from the root with matching first visits, entry and exit times, and every
+ * used cell of the sparse table holds the shallowest vertex of its range. Runs in O(n log n)
+ * @param index an index whose header was already checked
+ * @return false when any array is inconsistent
+ * */
+bool isValidTreeIndex(TreeIndex *index)
+{
+    int verticesCount = index->verticesCount;
+    int tourLength = index->tourLength;
+    int *childrenCount = calloc(verticesCount, sizeof(int));
+    int *marked = calloc(verticesCount, sizeof(int));
+    int *previousLevel, *currentLevel;
+    int vertexKey, neighbor, edge, parentEdges, enteredCount, level, half, expected, i;
+    bool valid = true;
+
+    // the parents lead to the root, the depth decreases by one at every step
+    for (vertexKey = 0; valid && (vertexKey < verticesCount); vertexKey++)
+    {
+        if ((index->depth[vertexKey] < 0) || (index->depth[vertexKey] >= verticesCount))
+        {
+            valid = false;
+        }
+        else if (vertexKey == index->root)
+        {
+            valid = (index->parent[vertexKey] == -1) && (index->depth[vertexKey] == 0);
+        }
+        else if ((index->parent[vertexKey] < 0) || (index->parent[vertexKey] >= verticesCount))
+        {
+            valid = false;
+        }
+        else
+        {
+            childrenCount[index->parent[vertexKey]]++;
+        }
+    }
+    for (vertexKey = 0; valid && (vertexKey < verticesCount); vertexKey++)
+    {
+        valid = (vertexKey == index->root) ||
+                (index->depth[vertexKey] == index->depth[index->parent[vertexKey]] + 1);
+    }
+
+    // the neighbors of every vertex are its parent once and each of its children once
+    valid = valid && (index->adjacencyOffsets[0] == 0) &&
+            (index->adjacencyOffsets[verticesCount] == 2 * index->edgesCount);
+    for (vertexKey = 0; valid && (vertexKey < verticesCount); vertexKey++)
+    {
+        valid = (index->adjacencyOffsets[vertexKey + 1] - index->adjacencyOffsets[vertexKey] ==
+                 childrenCount[vertexKey] + (vertexKey != index->root));
+        parentEdges = 0;
+        for (edge = index->adjacencyOffsets[vertexKey]; valid && (edge < index->adjacencyOffsets[vertexKey + 1]);
+             edge++)
+        {
+            neighbor = index->adjacency[edge];
+            if ((neighbor < 0) || (neighbor >= verticesCount))
+            {
+                valid = false;
+            }
+            else if (neighbor == index->parent[vertexKey])
+            {
+                parentEdges++;
+            }
+            else if ((index->parent[neighbor] == vertexKey) && !marked[neighbor])
+            {
+                marked[neighbor] = 1;
+            }
+            else
+            {
+                valid = false;
+            }
+        }
+        valid = valid && (parentEdges == (vertexKey != index->root));
+    }
+
+    // the tour starts and ends at the root and moves along an edge at every step, so it crosses every edge twice
+    valid = valid && (index->eulerTour[0] == index->root) && (index->eulerTour[tourLength - 1] == index->root);
+    memset(marked, 0, verticesCount * sizeof(int));
+    enteredCount = 0;
+    for (i = 0; valid && (i < tourLength); i++)
+    {
+        vertexKey = index->eulerTour[i];
+        if ((vertexKey < 0) || (vertexKey >= verticesCount) ||
+            ((i > 0) && (index->parent[vertexKey] != index->eulerTour[i - 1]) &&
+             (index->parent[index->eulerTour[i - 1]] != vertexKey)))
+        {
+            valid = false;
+        }
+        else if (!marked[vertexKey])
+        {
+            marked[vertexKey] = 1;
+            valid = (index->firstVisit[vertexKey] == i) && (index->entryTime[vertexKey] == enteredCount);
+            enteredCount++;
+        }
+
+        // the last visit of a vertex comes after all of its subtree was entered
+        if (valid)
+        {
+            childrenCount[vertexKey] = enteredCount - 1;
+        }
+    }
+    valid = valid && (enteredCount == verticesCount);
+    for (vertexKey = 0; valid && (vertexKey < verticesCount); vertexKey++)
+    {
+        valid = (index->exitTime[vertexKey] == childrenCount[vertexKey]);
+    }
+
+    // the ranges that do not fit in the tour are never read, and are not checked
+    valid = valid && (memcmp(index->sparseTable, index->eulerTour, tourLength * sizeof(int)) == 0);
+    for (level = 1; valid && (level < index->levels); level++)
+    {
+        previousLevel = index->sparseTable + (size_t) (level - 1) * tourLength;
+        currentLevel = index->sparseTable + (size_t) level * tourLength;
+        half = 1 << (level - 1);
+        for (i = 0; valid && (i + 2 * half <= tourLength); i++)
+        {
+            expected = (index->depth[previousLevel[i]] <= index->depth[previousLevel[i + half]]) ?
+                       previousLevel[i] : previousLevel[i + half];
+            valid = (currentLevel[i] == expected);
+        }
+    }
+
+    free(childrenCount);
+    free(marked);
+    return valid;
+}
+
+/**
+ * @brief Answers "metrics" by printing the same tree info as the default analysis
+ * @param engine
+ * @param args unused
+ * @param out the stream to print to
+ * */
+bool queryMetrics(QueryEngine *engine, long *args, FILE *out)
+{
+    TreeIndex *index = engine->index;
+
+    (void) args;
+
+    fprintf(out, "%s%d\n", ROOT_VERTEX_MSG, index->root);
+    fprintf(out, "%s%d\n", VERTICES_COUNT_MSG, index->verticesCount);
+    fprintf(out, "%s%d\n", EDGES_COUNT_MSG, index->edgesCount);
+    fprintf(out, "%s%lld\n", MINIMAL_BRACH_LENGTH_MSG, index->minBranchLength);
+    fprintf(out, "%s%lld\n", MAXIMAL_BRACH_LENGTH_MSG, index->maxBranchLength);
+    fprintf(out, "%s%lld\n", DIAMETER_LENGTH_MSG, index->diameter);
+    return true;
+}
+
+/**
+ * @brief Loads a tree once, preprocess it and writes the index to a file.
+ * Expects the arguments --build-index <Graph File Path> <Index File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runBuildIndexMode(char *argv[])
+{
+    Graph *graph;
+    TreeAnalysis *analysis;
+    TreeIndex *index;
+    bool success;
+
+    if (!loadTree(argv[MODE_FIRST_ARG_INDEX], &graph, &analysis))
+    {
+        return EXIT_FAILURE;
+    }
+
+    index = buildTreeIndex(graph, analysis);
+    freeTreeAnalysis(&analysis);
+    freeGraph(&graph);
+
+    success = writeTreeIndex(index, argv[MODE_SECOND_ARG_INDEX]);
+    if (!success)
+    {
+        fprintf(stderr, "%s", INVALID_INDEX_MSG);
+    }
+
+    freeTreeIndex(&index);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Maps an index file and answers every query in a queries file, without parsing the graph.
+ * Expects the arguments --query-index <Index File Path> <Queries File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runQueryIndexMode(char *argv[])
+{
+    QueryEngine engine;
+    TreeIndex *index;
+    bool success;
+
+    index = mapTreeIndex(argv[MODE_FIRST_ARG_INDEX]);
+    if (index == NULL)
+    {
+        fprintf(stderr, "%s", INVALID_INDEX_MSG);
+        return EXIT_FAILURE;
+    }
+    initQueryEngine(&engine, index);
+
+    success = runQueryFile(&engine, argv[MODE_SECOND_ARG_INDEX], stdout);
+
+    freeQueryEngine(&engine);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Reads a graph file in the text format, in the binary format or as a prufer sequence, which are recognized
+ * by their first bytes.
+ * Prints an error message on failure
+ * @param file the path of the graph file
+ * @param maxVertexKey the largest vertex the caller asks about. Input with less vertices is invalid
+ * @param graphPtr set to the built graph on success
+ * @param diagnostics the measurements of the run, or NULL
+ * @param errorOut the stream to print an error message to
+ * */
+bool readGraph(char *file, int maxVertexKey, Graph **graphPtr, Diagnostics *diagnostics, FILE *errorOut)
+{
+    GraphRows rows;
+    double start = getSeconds();
+    bool success;
+
+    if (isBinaryGraphFile(file))
+    {
+        success = parseBinaryGraphFile(file, maxVertexKey, graphPtr, errorOut);
+        recordPhase(diagnostics, "parseBinaryGraphFile", start);
+        return success;
+    }
+
+    if (isPruferFile(file))
+    {
+        success = parsePruferFile(file, maxVertexKey, graphPtr, errorOut);
+        recordPhase(diagnostics, "parsePruferFile", start);
+        return success;
+    }
+
+    success = parseGraphFile(&rows, file, maxVertexKey, true, errorOut);
+    recordPhase(diagnostics, "parseGraphFile", start);
+    if (diagnostics != NULL)
+    {
+        diagnostics->lineBytes = getGraphRowsBytes(&rows);
+    }
+    if (!success)
+    {
+        freeGraphRows(&rows);
+        return false;
+    }
+
+    // Attached the edges for each vertex, the text file data is not needed afterwards
+    start = getSeconds();
+    *graphPtr = initGraph(rows.verticesCount);
+    attachEdges(*graphPtr, &rows);
+    recordPhase(diagnostics, "attachEdges", start);
+    freeGraphRows(&rows);
+
+    return true;
+}
+
+/**
+ * @brief Checks whenever a file starts with the magic of the binary graph format
+ * @param file
+ * */
+bool isBinaryGraphFile(char *file)
+{
+    char magic[sizeof(BINARY_GRAPH_MAGIC)];
+    FILE *fp = fopen(file, "rb");
+    bool isBinary;
+
+    if (fp == NULL)
+    {
+        return false;
+    }
+
+    isBinary = (fread(magic, sizeof(magic), 1, fp) == 1) && (memcmp(magic, BINARY_GRAPH_MAGIC, sizeof(magic)) == 0);
+    fclose(fp);
+    return isBinary;
+}
+
+/**
+ * @brief Reads a varint and advances the cursor past it
+ * @param cursor
+ * @param end the end of the readable memory
+ * @param value set to the read value
+ * @return false when the varint is truncated or does not fit in 32 bits
+ * */
+bool readVarint(unsigned char **cursor, unsigned char *end, uint32_t *value)
+{
+    uint64_t result = 0;
+    int i;
+
+    for (i = 0; (i < VARINT_MAX_BYTES) && (*cursor < end); i++)
+    {
+        result |= (uint64_t) (**cursor & ~VARINT_CONTINUE_BIT) << (i * VARINT_PAYLOAD_BITS);
+        if ((*((*cursor)++) & VARINT_CONTINUE_BIT) == 0)
+        {
+            *value = (uint32_t) result;
+            return result <= UINT32_MAX;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Checks whenever a row of a binary graph file is valid, and advances the cursor past it
+ * @param cursor
+ * @param end the end of the file
+ * @param rowIndex the vertex the row belongs to
+ * @param numOfVertices
+ * */
+bool validateBinaryRow(unsigned char **cursor, unsigned char *end, int rowIndex, int numOfVertices)
+{
+    uint32_t neighborsCount, delta;
+    long long neighbor = rowIndex;
+    uint32_t i;
+
+    if (!readVarint(cursor, end, &neighborsCount))
+    {
+        return false;
+    }
+
+    for (i = 0; i < neighborsCount; i++)
+    {
+        if (!readVarint(cursor, end, &delta))
+        {
+            return false;
+        }
+
+        // undo the zigzag encoding of the difference
+        neighbor += (long long) (delta >> 1) ^ -(long long) (delta & 1);
+        if ((neighbor < 0) || (neighbor >= numOfVertices))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Adds the edges of a valid row of a binary graph file to a graph and to disjoint sets of its vertices, and
+ * advances the cursor past the row
+ * @param graph
+ * @param sets
+ * @param cursor
+ * @param rowIndex the vertex the row belongs to
+ * @param edgesCount the amount of edges added so far, incremented for every edge in the row
+ * @return false when an edge closes a cycle, or there are more edges than a tree has
+ * */
+bool addBinaryRowEdges(Graph *graph, DisjointSets *sets, unsigned char **cursor, int rowIndex, int *edgesCount)
+{
+    uint32_t neighborsCount = 0;
+    uint32_t delta = 0;
+    int neighbor = rowIndex;
+    uint32_t i;
+
+    // the row was validated, so it can not be truncated
+    readVarint(cursor, *cursor + VARINT_MAX_BYTES, &neighborsCount);
+    for (i = 0; i < neighborsCount; i++)
+    {
+        readVarint(cursor, *cursor + VARINT_MAX_BYTES, &delta);
+        neighbor += (int) ((delta >> 1) ^ -(delta & 1));
+
+        (*edgesCount)++;
+        if ((*edgesCount > graph->verticesCount - 1) || (!unionSets(sets, rowIndex, neighbor)))
+        {
+            return false;
+        }
+        addEdge(graph, rowIndex, neighbor);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Parses a binary graph file written by writeBinaryGraph, with the checks of parseGraphFile. The edges are
+ * added to the graph while they are read, without copying the file
+ * @param file the path of the binary graph file
+ * @param maxVertexKey the largest vertex the caller asks about. Input with less vertices is invalid
+ * @param graphPtr set to the built graph on success
+ * @param errorOut the stream to print an error message to
+ * */
+bool parseBinaryGraphFile(char *file, int maxVertexKey, Graph **graphPtr, FILE *errorOut)
+{
+    BinaryGraphHeader header;
+    struct stat fileStat;
+    unsigned char *mapping, *cursor, *rowStart, *end;
+    DisjointSets *sets;
+    int rowIndex;
+    int edgesCount = 0;
+    int fd;
+    bool success = true;
+    char *errorMsg = INVALID_INPUT_MSG;
+
+    fd = open(file, O_RDONLY);
+    if ((fd < 0) || (fstat(fd, &fileStat) != 0))
+    {
+        fprintf(errorOut, "%s", INVALID_USAGE_MSG);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return false;
+    }
+
+    // the magic was already checked, the rest of the header might be missing
+    if ((size_t) fileStat.st_size < sizeof(BinaryGraphHeader))
+    {
+        fprintf(errorOut, "%s", INVALID_INPUT_MSG);
+        close(fd);
+        return false;
+    }
+
+    mapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(errorOut, "%s", INVALID_USAGE_MSG);
+        return false;
+    }
+    posix_madvise(mapping, fileStat.st_size, POSIX_MADV_SEQUENTIAL);
+
+    // check the header, and whenever the vertices asked about are in the graph
+    memcpy(&header, mapping, sizeof(header));
+    if ((header.version != BINARY_GRAPH_VERSION) || (maxVertexKey >= header.verticesCount))
+    {
+        fprintf(errorOut, "%s", INVALID_INPUT_MSG);
+        munmap(mapping, fileStat.st_size);
+        return false;
+    }
+
+    // every row takes at least the byte of its degree, so a file too short for its rows is rejected before the
+    // graph is allocated
+    if ((size_t) fileStat.st_size - sizeof(header) < (size_t) header.verticesCount)
+    {
+        fprintf(errorOut, "%s", INVALID_INPUT_MSG);
+        munmap(mapping, fileStat.st_size);
+        return false;
+    }
+
+    *graphPtr = initGraph(header.verticesCount);
+    sets = initDisjointSets(header.verticesCount);
+    cursor = mapping + sizeof(header);
+    end = mapping + fileStat.st_size;
+
+    // every row is validated before any of its edges is added, as rows of the text format are
+    for (rowIndex = 0; (rowIndex < header.verticesCount) && success; rowIndex++)
+    {
+        rowStart = cursor;
+        if (!validateBinaryRow(&cursor, end, rowIndex, header.verticesCount))
+        {
+            success = false;
+        }
+        else if (!addBinaryRowEdges(*graphPtr, sets, &rowStart, rowIndex, &edgesCount))
+        {
+            errorMsg = GRAPH_NOT_TREE_MSG;
+            success = false;
+        }
+    }
+
+    // there should be no more rows, and a forest of n vertices and n-1 edges is a tree
+    if (success && (cursor != end))
+    {
+        success = false;
+    }
+    else if (success && (edgesCount != header.verticesCount - 1))
+    {
+        errorMsg = GRAPH_NOT_TREE_MSG;
+        success = false;
+    }
+
+    freeDisjointSets(&sets);
+    munmap(mapping, fileStat.st_size);
+
+    if (!success)
+    {
+        fprintf(errorOut, "%s", errorMsg);
+        freeGraph(graphPtr);
+    }
+
+    return success;
+}
+
+/**
+ * @brief Writes a value as a varint, 7 bits in every byte starting from the lowest ones
+ * @param fp
+ * @param value
+ * */
+void writeVarint(FILE *fp, uint32_t value)
+{
+    while (value >= VARINT_CONTINUE_BIT)
+    {
+        putc((int) ((value & ~VARINT_CONTINUE_BIT) | VARINT_CONTINUE_BIT), fp);
+        value >>= VARINT_PAYLOAD_BITS;
+    }
+    putc((int) value, fp);
+}
+
+/**
+ * @brief Writes the rows of a parsed text graph file as a binary graph file
+ * @param rows the parsed rows of the text file
+ * @param file the path of the binary graph file
+ * @return false when the file could not be written
+ * */
+bool writeBinaryGraph(GraphRows *rows, char *file)
+{
+    BinaryGraphHeader header;
+    FILE *fp;
+    long long neighbor, previous, delta;
+    int rowIndex;
+    int i;
+    bool success;
+
+    fp = fopen(file, "wb");
+    if (fp == NULL)
+    {
+        return false;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_GRAPH_MAGIC, sizeof(BINARY_GRAPH_MAGIC));
+    header.version = BINARY_GRAPH_VERSION;
+    header.verticesCount = rows->verticesCount;
+    fwrite(&header, sizeof(header), 1, fp);
+
+    for (rowIndex = 0; rowIndex < rows->verticesCount; rowIndex++)
+    {
+        writeVarint(fp, (uint32_t) (rows->offsets[rowIndex + 1] - rows->offsets[rowIndex]));
+
+        // write the zigzag encoded difference of every neighbor from the previous one
+        previous = rowIndex;
+        for (i = rows->offsets[rowIndex]; i < rows->offsets[rowIndex + 1]; i++)
+        {
+            neighbor = rows->neighbors[i];
+            delta = neighbor - previous;
+            writeVarint(fp, (uint32_t) ((delta < 0) ? -2 * delta - 1 : 2 * delta));
+            previous = neighbor;
+        }
+    }
+
+    success = !ferror(fp);
+    if (fclose(fp) != 0)
+    {
+        success = false;
+    }
+
+    return success;
+}
+
+/**
+ * @brief Converts a text graph file to a binary graph file, which is read without parsing any text.
+ * The graph is validated as if it was analyzed. Expects the arguments --convert <Graph File Path> <Binary File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runConvertMode(char *argv[])
+{
+    GraphRows rows;
+    bool success;
+
+    if (!parseGraphFile(&rows, argv[MODE_FIRST_ARG_INDEX], 0, true, stderr))
+    {
+        freeGraphRows(&rows);
+        return EXIT_FAILURE;
+    }
+
+    // the binary format has no edge weights
+    if (rows.weights != NULL)
+    {
+        fprintf(stderr, "%s", WEIGHTED_CONVERT_MSG);
+        freeGraphRows(&rows);
+        return EXIT_FAILURE;
+    }
+
+    success = writeBinaryGraph(&rows, argv[MODE_SECOND_ARG_INDEX]);
+    if (!success)
+    {
+        fprintf(stderr, "%s", BINARY_WRITE_FAILED_MSG);
+    }
+
+    freeGraphRows(&rows);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Checks whenever a file starts with the magic of the prufer format
+ * @param file
+ * */
+bool isPruferFile(char *file)
+{
+    char magic[sizeof(PRUFER_MAGIC) - 1];
+    FILE *fp = fopen(file, "rb");
+    bool isPrufer;
+
+    if (fp == NULL)
+    {
+        return false;
+    }
+
+    isPrufer = (fread(magic, sizeof(magic), 1, fp) == 1) && (memcmp(magic, PRUFER_MAGIC, sizeof(magic)) == 0);
+    fclose(fp);
+    return isPrufer;
+}
+
+/**
+ * @brief Reads the next number of a prufer file and advances the cursor past it
+ * @param cursor
+ * @param end the end of the file, readable for SWAR_WORD_LENGTH - 1 bytes after it
+ * @param value set to the read number
+ * @param found set to whenever a number was read, false at the end of the file
+ * @return false when the next characters are not a number followed by a separator or the end of the file
+ * */
+bool readPruferNumber(char **cursor, char *end, uint64_t *value, bool *found)
+{
+    char *c = *cursor;
+    int digitsCount;
+
+    // the file is terminated, so the separators end before its end
+    c += strspn(c, PRUFER_SEPARATORS);
+    *found = (c < end);
+    if (!*found)
+    {
+        *cursor = c;
+        return true;
+    }
+
+    digitsCount = parseDigits(c, value);
+    c += digitsCount;
+    if ((digitsCount == 0) || (digitsCount > MAX_PARSED_DIGITS) ||
+        ((c < end) && ((*c == '\0') || (strchr(PRUFER_SEPARATORS, *c) == NULL))))
+    {
+        return false;
+    }
+
+    *cursor = c;
+    return true;
+}
+
+/**
+ * @brief Parses a prufer file: the magic, the amount of vertices and the n-2 vertices of the sequence, separated by
+ * spaces or lines. The sequence is decoded in O(n) and the edges are added to the graph directly, as every sequence
+ * represents a tree and is not checked for cycles. The root of the tree is the last vertex
+ * @param file the path of the prufer file
+ * @param maxVertexKey the largest vertex the caller asks about. Input with less vertices is invalid
+ * @param graphPtr set to the built graph on success
+ * @param errorOut the stream to print an error message to
+ * */
+bool parsePruferFile(char *file, int maxVertexKey, Graph **graphPtr, FILE *errorOut)
+{
+    struct stat fileStat;
+    FILE *fp;
+    char *content, *cursor, *end;
+    uint64_t value = 0;
+    int *sequence = NULL;
+    int *parent;
+    int verticesCount = 0;
+    int sequenceLength = 0;
+    int vertexKey;
+    bool found = false;
+    bool success;
+
+    fp = fopen(file, "rb");
+    if ((fp == NULL) || (fstat(fileno(fp), &fileStat) != 0))
+    {
+        fprintf(errorOut, "%s", INVALID_USAGE_MSG);
+        if (fp != NULL)
+        {
+            fclose(fp);
+        }
+        return false;
+    }
+
+    // the numbers are parsed a word at a time, so the content is padded
+    content = calloc(fileStat.st_size + SWAR_WORD_LENGTH, 1);
+    success = (fread(content, 1, fileStat.st_size, fp) == (size_t) fileStat.st_size);
+    fclose(fp);
+    cursor = content + sizeof(PRUFER_MAGIC) - 1;
+    end = content + fileStat.st_size;
+
+    // every number of the sequence takes at least two characters, which bounds the amount of vertices
+    success = success && readPruferNumber(&cursor, end, &value, &found) && found && (value >= 1) &&
+              (value <= (uint64_t) fileStat.st_size + 2) && (value <= INT_MAX) && ((int) value > maxVertexKey);
+    if (success)
+    {
+        verticesCount = (int) value;
+        sequence = malloc(((verticesCount > 2) ? verticesCount - 2 : 1) * sizeof(int));
+    }
+
+    while (success)
+    {
+        success = readPruferNumber(&cursor, end, &value, &found);
+        if (!found)
+        {
+            break;
+        }
+        if ((!success) || (value >= (uint64_t) verticesCount) || (sequenceLength >= verticesCount - 2))
+        {
+            success = false;
+            break;
+        }
+        sequence[sequenceLength++] = (int) value;
+    }
+    free(content);
+
+    if ((!success) || (sequenceLength != ((verticesCount > 2) ? verticesCount - 2 : 0)))
+    {
+        fprintf(errorOut, "%s", INVALID_INPUT_MSG);
+        free(sequence);
+        return false;
+    }
+
+    parent = malloc(verticesCount * sizeof(int));
+    decodePruferSequence(sequence, verticesCount, parent);
+
+    *graphPtr = initGraph(verticesCount);
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        if (parent[vertexKey] != -1)
+        {
+            addEdge(*graphPtr, parent[vertexKey], vertexKey);
+        }
+    }
+
+    free(sequence);
+    free(parent);
+    return true;
+}
+
+/**
+ * @brief Encodes a tree as its prufer sequence, in O(n). The removed leaf is always the smallest one, found by a
+ * pointer that only moves forward as in decodePruferSequence. The last vertex is never removed, so the only vertex
+ * left next to a removed leaf is its parent when the tree is rooted at the last vertex
+ * @param parent the parents of the tree rooted at its last vertex, -1 for the root
+ * @param verticesCount
+ * @param sequence filled with the n-2 vertices of the sequence
+ * */
+void encodePruferSequence(int *parent, int verticesCount, int *sequence)
+{
+    int *degree = calloc(verticesCount, sizeof(int));
+    int vertexKey, i, leaf, nextLeaf;
+
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        if (parent[vertexKey] != -1)
+        {
+            degree[vertexKey]++;
+            degree[parent[vertexKey]]++;
+        }
+    }
+
+    // find the smallest leaf
+    nextLeaf = verticesCount - 1;
+    for (vertexKey = verticesCount - 1; vertexKey >= 0; vertexKey--)
+    {
+        if (degree[vertexKey] == 1)
+        {
+            nextLeaf = vertexKey;
+        }
+    }
+    leaf = nextLeaf;
+
+    for (i = 0; i < verticesCount - 2; i++)
+    {
+        sequence[i] = parent[leaf];
+        degree[leaf] = 0;
+
+        // the parent becomes the next leaf when it is smaller than the pointer
+        if ((--degree[sequence[i]] == 1) && (sequence[i] < nextLeaf))
+        {
+            leaf = sequence[i];
+            continue;
+        }
+
+        do
+        {
+            nextLeaf++;
+        } while (degree[nextLeaf] != 1);
+        leaf = nextLeaf;
+    }
+
+    free(degree);
+}
+
+/**
+ * @brief Writes a prufer sequence as a prufer file
+ * @param sequence the n-2 vertices of the sequence
+ * @param verticesCount
+ * @param file the path of the prufer file
+ * @return false when the file could not be written
+ * */
+bool writePruferFile(int *sequence, int verticesCount, char *file)
+{
+    FILE *fp;
+    int i;
+    bool success;
+
+    fp = fopen(file, "w");
+    if (fp == NULL)
+    {
+        return false;
+    }
+
+    fprintf(fp, "%s\n%d\n", PRUFER_MAGIC, verticesCount);
+    for (i = 0; i < verticesCount - 2; i++)
+    {
+        fprintf(fp, (i == 0) ? "%d" : " %d", sequence[i]);
+    }
+    if (verticesCount > 2)
+    {
+        fprintf(fp, "\n");
+    }
+
+    success = !ferror(fp);
+    if (fclose(fp) != 0)
+    {
+        success = false;
+    }
+
+    return success;
+}
+
+/**
+ * @brief Exports a tree as a prufer file, which is read back without parsing rows or checking for cycles. A prufer
+ * sequence does not keep the root, the tree read back is rooted at its last vertex.
+ * Expects the arguments --export-prufer <Graph File Path> <Prufer File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runExportPruferMode(char *argv[])
+{
+    Graph *graph;
+    TreeAnalysis *analysis;
+    int *order, *parent, *depth, *sequence;
+    int verticesCount;
+    int root;
+    bool success;
+
+    if (!loadTree(argv[MODE_FIRST_ARG_INDEX], &graph, &analysis))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // a prufer sequence has no edge weights
+    if (graph->weighted)
+    {
+        fprintf(stderr, "%s", WEIGHTED_PRUFER_MSG);
+        freeTreeAnalysis(&analysis);
+        freeGraph(&graph);
+        return EXIT_FAILURE;
+    }
+
+    verticesCount = graph->verticesCount;
+    order = malloc(verticesCount * sizeof(int));
+    parent = malloc(verticesCount * sizeof(int));
+    depth = malloc(verticesCount * sizeof(int));
+    sequence = malloc(((verticesCount > 2) ? verticesCount - 2 : 1) * sizeof(int));
+
+    root = verticesCount - 1;
+    findBfsLevels(graph, &root, 1, order, parent, depth);
+    encodePruferSequence(parent, verticesCount, sequence);
+
+    success = writePruferFile(sequence, verticesCount, argv[MODE_SECOND_ARG_INDEX]);
+    if (!success)
+    {
+        fprintf(stderr, "%s", PRUFER_WRITE_FAILED_MSG);
+    }
+
+    free(order);
+    free(parent);
+    free(depth);
+    free(sequence);
+    freeTreeAnalysis(&analysis);
+    freeGraph(&graph);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Sort the vertices of a tree by their distance from the root, with counting sort. Every vertex comes after
+ * its parent in the result. The amount of vertices in every depth is stored in the metrics
+ * @param graph
+ * @param analysis an analysis that already holds the distances from the root
+ * @param metrics
+ * @param order filled with the sorted vertices
+ * */
+void sortVerticesByDepth(Graph *graph, TreeAnalysis *analysis, TreeMetrics *metrics, int *order)
+{
+    int verticesCount = graph->verticesCount;
+    int *depthStart;
+    int vertexKey, depth;
+
+    // the deepest vertex is the end of the maximal branch
+    metrics->depthsCount = 0;
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        if (analysis->distFromRoot[vertexKey] >= metrics->depthsCount)
+        {
+            metrics->depthsCount = analysis->distFromRoot[vertexKey] + 1;
+        }
+    }
+
+    metrics->widthPerDepth = calloc(metrics->depthsCount, sizeof(int));
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        metrics->widthPerDepth[analysis->distFromRoot[vertexKey]]++;
+    }
+
+    // every depth starts where the previous one ends
+    depthStart = malloc(metrics->depthsCount * sizeof(int));
+    depthStart[0] = 0;
+    for (depth = 1; depth < metrics->depthsCount; depth++)
+    {
+        depthStart[depth] = depthStart[depth - 1] + metrics->widthPerDepth[depth - 1];
+    }
+
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        order[depthStart[analysis->distFromRoot[vertexKey]]++] = vertexKey;
+    }
+
+    free(depthStart);
+}
+
+/**
+ * @brief Find the metrics of every vertex of a tree in linear time. The height of every subtree is found bottom up,
+ * and the eccentricities are found top down by rerooting: the farthest vertex from a vertex is either below it, or
+ * reached through its parent, either above the parent or below one of its other children. The heights and the
+ * eccentricities are sums of the weights in a weighted tree, every edge of an unweighted tree weighs 1
+ * @param graph a tree whose root is set
+ * @param analysis an analysis that already holds the distances from the root and the traversal sources
+ * */
+TreeMetrics *findTreeMetrics(Graph *graph, TreeAnalysis *analysis)
+{
+    TreeMetrics *metrics = malloc(sizeof(TreeMetrics));
+    int verticesCount = graph->verticesCount;
+    int *order = malloc(verticesCount * sizeof(int));
+    long long *height = calloc(verticesCount, sizeof(long long));
+    long long *secondHeight = calloc(verticesCount, sizeof(long long));
+    int *highestChild = malloc(verticesCount * sizeof(int));
+    long long throughParent;
+    int vertexKey, childKey;
+    int i;
+    Vertex *temp;
+
+    metrics->verticesCount = verticesCount;
+    metrics->eccentricity = malloc(verticesCount * sizeof(long long));
+    metrics->subtreeSize = malloc(verticesCount * sizeof(int));
+    sortVerticesByDepth(graph, analysis, metrics, order);
+
+    // find the sizes and the two largest heights of the subtrees of every vertex, children first
+    for (i = verticesCount - 1; i >= 0; i--)
+    {
+        vertexKey = order[i];
+        metrics->subtreeSize[vertexKey] = 1;
+        highestChild[vertexKey] = -1;
+
+        temp = graph->listOfAdjacent[vertexKey];
+        while (temp)
+        {
+            childKey = temp->vertexKey;
+            if (childKey != analysis->parent[vertexKey])
+            {
+                metrics->subtreeSize[vertexKey] += metrics->subtreeSize[childKey];
+
+                if (height[childKey] + temp->weight > height[vertexKey])
+                {
+                    secondHeight[vertexKey] = height[vertexKey];
+                    height[vertexKey] = height[childKey] + temp->weight;
+                    highestChild[vertexKey] = childKey;
+                }
+                else if (height[childKey] + temp->weight > secondHeight[vertexKey])
+                {
+                    secondHeight[vertexKey] = height[childKey] + temp->weight;
+                }
+            }
+            temp = temp->next;
+        }
+    }
+
+    /* the eccentricity of every vertex holds the longest path going up from it until the vertex itself is reached,
+     * which is after its parent*/
+    metrics->eccentricity[graph->root] = 0;
+    for (i = 0; i < verticesCount; i++)
+    {
+        vertexKey = order[i];
+
+        temp = graph->listOfAdjacent[vertexKey];
+        while (temp)
+        {
+            if (temp->vertexKey != analysis->parent[vertexKey])
+            {
+                // the longest path from the vertex which does not go down to the child
+                throughParent = (highestChild[vertexKey] == temp->vertexKey) ? secondHeight[vertexKey] :
+                                height[vertexKey];
+                if (metrics->eccentricity[vertexKey] > throughParent)
+                {
+                    throughParent = metrics->eccentricity[vertexKey];
+                }
+                metrics->eccentricity[temp->vertexKey] = throughParent + temp->weight;
+            }
+            temp = temp->next;
+        }
+
+        if (height[vertexKey] > metrics->eccentricity[vertexKey])
+        {
+            metrics->eccentricity[vertexKey] = height[vertexKey];
+        }
+    }
+
+    findCentersAndCentroids(graph, analysis, metrics);
+
+    free(order);
+    free(height);
+    free(secondHeight);
+    free(highestChild);
+    return metrics;
+}
+
+/**
+ * @brief Find the centers and the centroids of a tree, in increasing order
+ * @param graph
+ * @param analysis an analysis that already holds the traversal sources from the root
+ * @param metrics holding the eccentricities and the subtree sizes
+ * */
+void findCentersAndCentroids(Graph *graph, TreeAnalysis *analysis, TreeMetrics *metrics)
+{
+    int verticesCount = graph->verticesCount;
+    int vertexKey, largestPart;
+    Vertex *temp;
+
+    metrics->radius = metrics->eccentricity[0];
+    for (vertexKey = 1; vertexKey < verticesCount; vertexKey++)
+    {
+        if (metrics->eccentricity[vertexKey] < metrics->radius)
+        {
+            metrics->radius = metrics->eccentricity[vertexKey];
+        }
+    }
+
+    metrics->centersCount = 0;
+    metrics->centroidsCount = 0;
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        if ((metrics->eccentricity[vertexKey] == metrics->radius) && (metrics->centersCount < MAX_CENTERS))
+        {
+            metrics->centers[metrics->centersCount++] = vertexKey;
+        }
+
+        // the largest part left when the vertex is removed, above it or below one of its children
+        largestPart = verticesCount - metrics->subtreeSize[vertexKey];
+        temp = graph->listOfAdjacent[vertexKey];
+        while (temp)
+        {
+            if ((temp->vertexKey != analysis->parent[vertexKey]) &&
+                (metrics->subtreeSize[temp->vertexKey] > largestPart))
+            {
+                largestPart = metrics->subtreeSize[temp->vertexKey];
+            }
+            temp = temp->next;
+        }
+
+        if ((2 * largestPart <= verticesCount) && (metrics->centroidsCount < MAX_CENTERS))
+        {
+            metrics->centroids[metrics->centroidsCount++] = vertexKey;
+        }
+    }
+}
+
+/**
+ * @brief Release the memory allocated to the metrics of a tree
+ * @param metricsPtr
+ * */
+void freeTreeMetrics(TreeMetrics **metricsPtr)
+{
+    free((*metricsPtr)->eccentricity);
+    free((*metricsPtr)->subtreeSize);
+    free((*metricsPtr)->widthPerDepth);
+    free(*metricsPtr);
+    *metricsPtr = NULL;
+}
+
+/**
+ * @brief Prints a message followed by a line of numbers separated by spaces
+ * @param msg
+ * @param vertices
+ * @param count
+ * */
+void printVerticesLine(char *msg, int *vertices, int count)
+{
+    int i;
+
+    printf("%s", msg);
+    for (i = 0; i < count; i++)
+    {
+        printf((i == 0) ? "%d" : " %d", vertices[i]);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Prints a message followed by a line of path lengths separated by spaces
+ * @param msg
+ * @param lengths
+ * @param count
+ * */
+void printLengthsLine(char *msg, long long *lengths, int count)
+{
+    int i;
+
+    printf("%s", msg);
+    for (i = 0; i < count; i++)
+    {
+        printf((i == 0) ? "%lld" : " %lld", lengths[i]);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Prints the info of a tree followed by its metrics
+ * @param graph
+ * @param analysis
+ * @param metrics
+ * */
+void printTreeMetrics(Graph *graph, TreeAnalysis *analysis, TreeMetrics *metrics)
+{
+    printf("%s%d\n", ROOT_VERTEX_MSG, graph->root);
+    printf("%s%d\n", VERTICES_COUNT_MSG, graph->verticesCount);
+    printf("%s%d\n", EDGES_COUNT_MSG, graph->edgesCount);
+    printTreeDistanceInfo(graph, analysis);
+
+    printf("%s%lld\n", RADIUS_MSG, metrics->radius);
+    printVerticesLine(CENTER_MSG, metrics->centers, metrics->centersCount);
+    printVerticesLine(CENTROID_MSG, metrics->centroids, metrics->centroidsCount);
+    printLengthsLine(ECCENTRICITIES_MSG, metrics->eccentricity, metrics->verticesCount);
+    printVerticesLine(SUBTREE_SIZES_MSG, metrics->subtreeSize, metrics->verticesCount);
+    printVerticesLine(WIDTH_PER_DEPTH_MSG, metrics->widthPerDepth, metrics->depthsCount);
+}
+
+/**
+ * @brief Prints the metrics of every vertex of a tree, without traversing it from every vertex.
+ * Expects the arguments --metrics <Graph File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runMetricsMode(char *argv[])
+{
+    Graph *graph;
+    TreeAnalysis *analysis;
+    TreeMetrics *metrics;
+
+    if (!loadTree(argv[MODE_FIRST_ARG_INDEX], &graph, &analysis))
+    {
+        return EXIT_FAILURE;
+    }
+
+    metrics = findTreeMetrics(graph, analysis);
+    printTreeMetrics(graph, analysis, metrics);
+
+    freeTreeMetrics(&metrics);
+    freeTreeAnalysis(&analysis);
+    freeGraph(&graph);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Make sure a dynamic tree can hold a given amount of vertices. The arrays grow by doubling, so adding
+ * vertices one at a time takes amortized O(1)
+ * @param tree
+ * @param verticesCount
+ * */
+void reserveDynamicTree(DynamicTree *tree, int verticesCount)
+{
+    if (verticesCount <= tree->capacity)
+    {
+        return;
+    }
+
+    while (tree->capacity < verticesCount)
+    {
+        tree->capacity = (tree->capacity > 0) ? 2 * tree->capacity : verticesCount;
+    }
+
+    tree->parent = realloc(tree->parent, tree->capacity * sizeof(int));
+    tree->depth = realloc(tree->depth, tree->capacity * sizeof(int));
+    tree->jump = realloc(tree->jump, tree->capacity * sizeof(int));
+}
+
+/**
+ * @brief Sets the parent of a vertex in a dynamic tree, and its depth and jump pointer. The jump pointer skips as
+ * far as the jump pointer of the parent and then as far again when those two skips have the same length, otherwise
+ * it is the parent. This keeps O(log n) skips between any vertex and any of its ancestors
+ * @param tree
+ * @param vertexKey
+ * @param parentKey an existing vertex, or -1 for the root
+ * */
+void setDynamicVertex(DynamicTree *tree, int vertexKey, int parentKey)
+{
+    int parentJump;
+
+    tree->parent[vertexKey] = parentKey;
+    if (parentKey == -1)
+    {
+        tree->depth[vertexKey] = 0;
+        tree->jump[vertexKey] = vertexKey;
+        return;
+    }
+
+    tree->depth[vertexKey] = tree->depth[parentKey] + 1;
+    parentJump = tree->jump[parentKey];
+    if (tree->depth[parentKey] - tree->depth[parentJump] == tree->depth[parentJump] - tree->depth[tree->jump[parentJump]])
+    {
+        tree->jump[vertexKey] = tree->jump[parentJump];
+    }
+    else
+    {
+        tree->jump[vertexKey] = parentKey;
+    }
+
+    if (tree->depth[vertexKey] > tree->maxBranchLength)
+    {
+        tree->maxBranchLength = tree->depth[vertexKey];
+    }
+}
+
+/**
+ * @brief Adds the vertices of a rooted tree to a dynamic tree. Vertex k of the tree becomes the vertex n+k, where
+ * n is the amount of vertices before they were added. Every vertex is set after its parent
+ * @param tree
+ * @param parent the parent of every vertex of the added tree, -1 for its root
+ * @param count the amount of vertices of the added tree
+ * @param attachTo the vertex the root of the added tree becomes a child of, -1 when the dynamic tree is empty
+ * */
+void addDynamicVertices(DynamicTree *tree, int *parent, int count, int attachTo)
+{
+    int offset = tree->verticesCount;
+    int *stack = malloc(count * sizeof(int));
+    int stackSize = 0;
+    int vertexIndex, currentIndex;
+
+    reserveDynamicTree(tree, offset + count);
+    for (vertexIndex = 0; vertexIndex < count; vertexIndex++)
+    {
+        tree->depth[offset + vertexIndex] = -1;
+    }
+
+    for (vertexIndex = 0; vertexIndex < count; vertexIndex++)
+    {
+        // climb until a vertex which was already set, or the root of the added tree
+        for (currentIndex = vertexIndex; (currentIndex != -1) && (tree->depth[offset + currentIndex] == -1);
+             currentIndex = parent[currentIndex])
+        {
+            stack[stackSize++] = currentIndex;
+        }
+
+        // set the vertices from the highest one down
+        while (stackSize > 0)
+        {
+            currentIndex = stack[--stackSize];
+            setDynamicVertex(tree, offset + currentIndex,
+                             (parent[currentIndex] == -1) ? attachTo : offset + parent[currentIndex]);
+        }
+    }
+
+    tree->verticesCount = offset + count;
+    free(stack);
+}
+
+/**
+ * @brief Initialize a dynamic tree holding a loaded tree
+ * @param analysis an analysis that already holds the traversal sources from the root
+ * @param verticesCount the amount of vertices of the loaded tree
+ * */
+DynamicTree *initDynamicTree(TreeAnalysis *analysis, int verticesCount)
+{
+    DynamicTree *tree = malloc(sizeof(DynamicTree));
+
+    tree->verticesCount = 0;
+    tree->capacity = 0;
+    tree->parent = NULL;
+    tree->depth = NULL;
+    tree->jump = NULL;
+    tree->maxBranchLength = 0;
+
+    addDynamicVertices(tree, analysis->parent, verticesCount, -1);
+    tree->root = findDynamicAncestor(tree, 0, 0);
+    findRangeDiameter(tree, 0, verticesCount, tree->diameterEnds, &tree->diameter);
+
+    return tree;
+}
+
+/**
+ * @brief Release the memory allocated to a dynamic tree
+ * @param treePtr
+ * */
+void freeDynamicTree(DynamicTree **treePtr)
+{
+    free((*treePtr)->parent);
+    free((*treePtr)->depth);
+    free((*treePtr)->jump);
+    free(*treePtr);
+    *treePtr = NULL;
+}
+
+/**
+ * @brief Find the ancestor of a vertex in a given depth in O(log n)
+ * @param tree
+ * @param vertexKey
+ * @param depth at most the depth of the vertex
+ * */
+int findDynamicAncestor(DynamicTree *tree, int vertexKey, int depth)
+{
+    while (tree->depth[vertexKey] > depth)
+    {
+        vertexKey = (tree->depth[tree->jump[vertexKey]] >= depth) ? tree->jump[vertexKey] : tree->parent[vertexKey];
+    }
+
+    return vertexKey;
+}
+
+/**
+ * @brief Find the lowest common ancestor of two vertices in O(log n). Vertices in the same depth have jump pointers
+ * to the same depth, so both climb together until their ancestors meet
+ * @param tree
+ * @param uVertexKey
+ * @param vVertexKey
+ * */
+int findDynamicLca(DynamicTree *tree, int uVertexKey, int vVertexKey)
+{
+    if (tree->depth[uVertexKey] > tree->depth[vVertexKey])
+    {
+        uVertexKey = findDynamicAncestor(tree, uVertexKey, tree->depth[vVertexKey]);
+    }
+    else
+    {
+        vVertexKey = findDynamicAncestor(tree, vVertexKey, tree->depth[uVertexKey]);
+    }
+
+    while (uVertexKey != vVertexKey)
+    {
+        if (tree->jump[uVertexKey] != tree->jump[vVertexKey])
+        {
+            uVertexKey = tree->jump[uVertexKey];
+            vVertexKey = tree->jump[vVertexKey];
+        }
+        else
+        {
+            uVertexKey = tree->parent[uVertexKey];
+            vVertexKey = tree->parent[vVertexKey];
+        }
+    }
+
+    return uVertexKey;
+}
+
+/**
+ * @brief Find the length of the path between two vertices in O(log n)
+ * @param tree
+ * @param uVertexKey
+ * @param vVertexKey
+ * */
+int findDynamicDistance(DynamicTree *tree, int uVertexKey, int vVertexKey)
+{
+    int lca = findDynamicLca(tree, uVertexKey, vVertexKey);
+
+    return tree->depth[uVertexKey] + tree->depth[vVertexKey] - 2 * tree->depth[lca];
+}
+
+/**
+ * @brief Find a longest path in a subtree whose vertices are a range of keys. Its deepest vertex is an endpoint of
+ * such a path, and the other endpoint is the farthest vertex from it
+ * @param tree
+ * @param firstVertexKey the first vertex of the range
+ * @param endVertexKey the end of the range
+ * @param ends filled with the endpoints of the path
+ * @param diameter set to the length of the path
+ * */
+void findRangeDiameter(DynamicTree *tree, int firstVertexKey, int endVertexKey, int *ends, int *diameter)
+{
+    int vertexKey, distance;
+
+    ends[0] = firstVertexKey;
+    for (vertexKey = firstVertexKey; vertexKey < endVertexKey; vertexKey++)
+    {
+        if (tree->depth[vertexKey] > tree->depth[ends[0]])
+        {
+            ends[0] = vertexKey;
+        }
+    }
+
+    ends[1] = ends[0];
+    *diameter = 0;
+    for (vertexKey = firstVertexKey; vertexKey < endVertexKey; vertexKey++)
+    {
+        distance = findDynamicDistance(tree, ends[0], vertexKey);
+        if (distance > *diameter)
+        {
+            ends[1] = vertexKey;
+            *diameter = distance;
+        }
+    }
+}
+
+/**
+ * @brief Updates the diameter of a dynamic tree after a subtree was attached to it. A longest path of the joined
+ * tree is a longest path of one of the parts, or connects an endpoint of the diameter of each part
+ * @param tree
+ * @param ends the endpoints of a longest path in the attached subtree
+ * @param diameter the length of that path
+ * */
+void mergeDiameter(DynamicTree *tree, int *ends, int diameter)
+{
+    int oldEnds[2];
+    int i, j, distance;
+
+    oldEnds[0] = tree->diameterEnds[0];
+    oldEnds[1] = tree->diameterEnds[1];
+
+    if (diameter > tree->diameter)
+    {
+        tree->diameterEnds[0] = ends[0];
+        tree->diameterEnds[1] = ends[1];
+        tree->diameter = diameter;
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        for (j = 0; j < 2; j++)
+        {
+            distance = findDynamicDistance(tree, oldEnds[i], ends[j]);
+            if (distance > tree->diameter)
+            {
+                tree->diameterEnds[0] = oldEnds[i];
+                tree->diameterEnds[1] = ends[j];
+                tree->diameter = distance;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Parses a vertex of a dynamic tree at the start of the arguments of an operation
+ * @param tree
+ * @param args
+ * @param end set to the text after the vertex
+ * @param vertexKey set to the parsed vertex
+ * @return false when the arguments do not start with a vertex of the tree
+ * */
+bool parseVertexArg(DynamicTree *tree, char *args, char **end, int *vertexKey)
+{
+    long value = strtol(args, end, 10);
+
+    if ((*end == args) || ((**end != ' ') && (**end != '\0')) || (value < 0) || (value >= tree->verticesCount))
+    {
+        return false;
+    }
+
+    *vertexKey = (int) value;
+    return true;
+}
+
+/**
+ * @brief Performs "add-leaf p", adding a new vertex as a child of p. The new vertex gets the next free key
+ * @param tree
+ * @param args the vertex p
+ * @param out unused
+ * */
+bool operationAddLeaf(DynamicTree *tree, char *args, FILE *out)
+{
+    int parentKey;
+    int ends[2];
+    char *end;
+
+    (void) out;
+    if ((!parseVertexArg(tree, args, &end, &parentKey)) || (end[strspn(end, " ")] != '\0'))
+    {
+        return false;
+    }
+
+    reserveDynamicTree(tree, tree->verticesCount + 1);
+    setDynamicVertex(tree, tree->verticesCount, parentKey);
+
+    // a single vertex is a subtree whose diameter is 0
+    ends[0] = tree->verticesCount;
+    ends[1] = tree->verticesCount;
+    tree->verticesCount++;
+    mergeDiameter(tree, ends, 0);
+
+    return true;
+}
+
+/**
+ * @brief Performs "attach-subtree p <Graph File Path>", attaching the root of the tree in the graph file as a child
+ * of p. Vertex k of the attached tree gets the key n+k, where n is the amount of vertices before the operation
+ * @param tree
+ * @param args the vertex p and the path of the graph file
+ * @param out unused
+ * */
+bool operationAttachSubtree(DynamicTree *tree, char *args, FILE *out)
+{
+    Graph *graph;
+    TreeAnalysis *analysis;
+    int parentKey, offset;
+    int ends[2];
+    int diameter;
+    char *file;
+
+    (void) out;
+    if (!parseVertexArg(tree, args, &file, &parentKey))
+    {
+        return false;
+    }
+
+    file += strspn(file, " ");
+    if ((*file == '\0') || (!loadTree(file, &graph, &analysis)))
+    {
+        return false;
+    }
+
+    offset = tree->verticesCount;
+    addDynamicVertices(tree, analysis->parent, graph->verticesCount, parentKey);
+    findRangeDiameter(tree, offset, tree->verticesCount, ends, &diameter);
+    mergeDiameter(tree, ends, diameter);
+
+    freeTreeAnalysis(&analysis);
+    freeGraph(&graph);
+    return true;
+}
+
+/**
+ * @brief Performs "info", printing the metrics kept by the tree
+ * @param tree
+ * @param args nothing
+ * @param out the stream to print to
+ * */
+bool operationInfo(DynamicTree *tree, char *args, FILE *out)
+{
+    if (args[strspn(args, " ")] != '\0')
+    {
+        return false;
+    }
+
+    fprintf(out, "%s%d\n", ROOT_VERTEX_MSG, tree->root);
+    fprintf(out, "%s%d\n", VERTICES_COUNT_MSG, tree->verticesCount);
+    fprintf(out, "%s%d\n", EDGES_COUNT_MSG, tree->verticesCount - 1);
+    fprintf(out, "%s%d\n", MAXIMAL_BRACH_LENGTH_MSG, tree->maxBranchLength);
+    fprintf(out, "%s%d\n", DIAMETER_LENGTH_MSG, tree->diameter);
+    fprintf(out, "%s%d %d\n", DIAMETER_ENDPOINTS_MSG, tree->diameterEnds[0], tree->diameterEnds[1]);
+    return true;
+}
+
+/**
+ * @brief Parses a single line of the form "<operation name> <arguments>" and performs it. Empty lines are ignored
+ * @param tree
+ * @param line
+ * @param out the stream to print to
+ * @return false when the line is not a valid operation
+ * */
+bool executeDynamicOperation(DynamicTree *tree, char *line, FILE *out)
+{
+    int operationsCount = sizeof(DYNAMIC_OPERATIONS) / sizeof(DYNAMIC_OPERATIONS[0]);
+    char name[QUERY_NAME_LENGTH];
+    int nameLength = 0;
+    int i;
+
+    // read the operation name
+    if (sscanf(line, "%31s%n", name, &nameLength) != 1)
+    {
+        return true;
+    }
+
+    for (i = 0; i < operationsCount; i++)
+    {
+        if (strcmp(DYNAMIC_OPERATIONS[i].name, name) == 0)
+        {
+            return DYNAMIC_OPERATIONS[i].run(tree, line + nameLength + strspn(line + nameLength, " "), out);
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Loads a tree once and performs every operation in an operations file on it, one operation per line.
+ * Expects the arguments --dynamic <Graph File Path> <Operations File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runDynamicMode(char *argv[])
+{
+    Graph *graph;
+    TreeAnalysis *analysis;
+    DynamicTree *tree;
+    FILE *fp;
+    char line[MAX_ROW_LENGTH + 1];
+    bool success = true;
+
+    if (!loadTree(argv[MODE_FIRST_ARG_INDEX], &graph, &analysis))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // only the parents are needed for building the dynamic tree
+    tree = initDynamicTree(analysis, graph->verticesCount);
+    freeTreeAnalysis(&analysis);
+    freeGraph(&graph);
+
+    fp = fopen(argv[MODE_SECOND_ARG_INDEX], "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "%s", DYNAMIC_USAGE_MSG);
+        freeDynamicTree(&tree);
+        return EXIT_FAILURE;
+    }
+
+    while (success && (fgets(line, sizeof(line), fp) != NULL))
+    {
+        // remove line terminators
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (!executeDynamicOperation(tree, line, stdout))
+        {
+            fprintf(stderr, "%s", INVALID_OPERATION_MSG);
+            success = false;
+        }
+    }
+
+    fclose(fp);
+    freeDynamicTree(&tree);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Find the next number of a xorshift random generator, which is the same on every platform
+ * @param randomState
+ * */
+uint64_t nextRandom(uint64_t *randomState)
+{
+    *randomState ^= *randomState << 13;
+    *randomState ^= *randomState >> 7;
+    *randomState ^= *randomState << 17;
+    return *randomState;
+}
+
+/**
+ * @brief Generates a path, in which every vertex is the parent of the next one. Stresses the depth of traversals
+ * @param parent
+ * @param verticesCount
+ * @param arity unused
+ * @param randomState unused
+ * */
+void generatePath(int *parent, int verticesCount, int arity, uint64_t *randomState)
+{
+    int vertexKey;
+
+    (void) arity;
+    (void) randomState;
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        parent[vertexKey] = vertexKey - 1;
+    }
+}
+
+/**
+ * @brief Generates a star, in which every vertex is a child of the first one. Stresses the length of rows
+ * @param parent
+ * @param verticesCount
+ * @param arity unused
+ * @param randomState unused
+ * */
+void generateStar(int *parent, int verticesCount, int arity, uint64_t *randomState)
+{
+    int vertexKey;
+
+    (void) arity;
+    (void) randomState;
+    parent[0] = -1;
+    for (vertexKey = 1; vertexKey < verticesCount; vertexKey++)
+    {
+        parent[vertexKey] = 0;
+    }
+}
+
+/**
+ * @brief Generates a complete tree, in which every vertex has arity children in the order of the vertices
+ * @param parent
+ * @param verticesCount
+ * @param arity the amount of children of every vertex
+ * @param randomState unused
+ * */
+void generateKary(int *parent, int verticesCount, int arity, uint64_t *randomState)
+{
+    int vertexKey;
+
+    (void) randomState;
+    parent[0] = -1;
+    for (vertexKey = 1; vertexKey < verticesCount; vertexKey++)
+    {
+        parent[vertexKey] = (vertexKey - 1) / arity;
+    }
+}
+
+/**
+ * @brief Decodes a prufer sequence to the tree it represents, in O(n). The removed leaf is always the smallest
+ * one, and it is found by a pointer that only moves forward, unless removing a leaf makes a smaller leaf
+ * @param sequence the n-2 vertices of the sequence
+ * @param verticesCount
+ * @param parent filled with the vertex every removed leaf was attached to. The last vertex is never removed, it is
+ * the root
+ * */
+void decodePruferSequence(int *sequence, int verticesCount, int *parent)
+{
+    int *degree = malloc(verticesCount * sizeof(int));
+    int vertexKey, i, leaf, nextLeaf;
+
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        degree[vertexKey] = 1;
+    }
+    for (i = 0; i < verticesCount - 2; i++)
+    {
+        degree[sequence[i]]++;
+    }
+
+    // find the smallest leaf
+    nextLeaf = verticesCount - 1;
+    for (vertexKey = verticesCount - 1; vertexKey >= 0; vertexKey--)
+    {
+        if (degree[vertexKey] == 1)
+        {
+            nextLeaf = vertexKey;
+        }
+    }
+    leaf = nextLeaf;
+
+    for (i = 0; i < verticesCount - 2; i++)
+    {
+        parent[leaf] = sequence[i];
+        degree[leaf] = 0;
+
+        // the attached vertex becomes the next leaf when it is smaller than the pointer
+        if ((--degree[sequence[i]] == 1) && (sequence[i] < nextLeaf))
+        {
+            leaf = sequence[i];
+            continue;
+        }
+
+        do
+        {
+            nextLeaf++;
+        } while (degree[nextLeaf] != 1);
+        leaf = nextLeaf;
+    }
+
+    // the remaining leaf is attached to the last vertex
+    parent[verticesCount - 1] = -1;
+    if (verticesCount > 1)
+    {
+        parent[leaf] = verticesCount - 1;
+    }
+
+    free(degree);
+}
+
+/**
+ * @brief Generates a uniformly random tree, by decoding a random prufer sequence
+ * @param parent
+ * @param verticesCount
+ * @param arity unused
+ * @param randomState
+ * */
+void generatePrufer(int *parent, int verticesCount, int arity, uint64_t *randomState)
+{
+    int *sequence = malloc(((verticesCount > 2) ? verticesCount - 2 : 1) * sizeof(int));
+    int i;
+
+    (void) arity;
+    for (i = 0; i < verticesCount - 2; i++)
+    {
+        sequence[i] = (int) (nextRandom(randomState) % verticesCount);
+    }
+
+    decodePruferSequence(sequence, verticesCount, parent);
+    free(sequence);
+}
+
+/**
+ * @brief Generates a caterpillar, a path holding half of the vertices with every other vertex attached to a random
+ * vertex of the path
+ * @param parent
+ * @param verticesCount
+ * @param arity unused
+ * @param randomState
+ * */
+void generateCaterpillar(int *parent, int verticesCount, int arity, uint64_t *randomState)
+{
+    int spineLength = (verticesCount + 1) / 2;
+    int vertexKey;
+
+    (void) arity;
+    for (vertexKey = 0; vertexKey < spineLength; vertexKey++)
+    {
+        parent[vertexKey] = vertexKey - 1;
+    }
+    for (vertexKey = spineLength; vertexKey < verticesCount; vertexKey++)
+    {
+        parent[vertexKey] = (int) (nextRandom(randomState) % spineLength);
+    }
+}
+
+/**
+ * @brief Find the generator of a given kind of tree
+ * @param kind the name of the kind, kary-<k> for complete k-ary trees
+ * @param arity set to k for complete k-ary trees
+ * @return the generator, or NULL when the kind is unknown
+ * */
+const TreeGenerator *findTreeGenerator(char *kind, int *arity)
+{
+    int generatorsCount = sizeof(TREE_GENERATORS) / sizeof(TREE_GENERATORS[0]);
+    char *arityText;
+    long arityValue;
+    int i;
+
+    *arity = 0;
+    for (i = 0; i < generatorsCount; i++)
+    {
+        if (!TREE_GENERATORS[i].takesArity)
+        {
+            if (strcmp(TREE_GENERATORS[i].name, kind) == 0)
+            {
+                return &TREE_GENERATORS[i];
+            }
+            continue;
+        }
+
+        // the name is followed by a positive arity
+        if (strncmp(TREE_GENERATORS[i].name, kind, strlen(TREE_GENERATORS[i].name)) == 0)
+        {
+            arityText = kind + strlen(TREE_GENERATORS[i].name);
+            if ((nonNumerical(arityText) != 0) || (!containsNumber(arityText)))
+            {
+                return NULL;
+            }
+
+            arityValue = strtol(arityText, NULL, 10);
+            if ((arityValue <= 0) || (arityValue > INT_MAX))
+            {
+                return NULL;
+            }
+
+            *arity = (int) arityValue;
+            return &TREE_GENERATORS[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find a random edge which is not in a generated tree, so adding it closes a cycle
+ * @param parent the parents of the tree, which has at least 3 vertices
+ * @param verticesCount
+ * @param randomState
+ * @param extraEdge filled with the vertices of the edge
+ * */
+void findExtraEdge(int *parent, int verticesCount, uint64_t *randomState, int *extraEdge)
+{
+    do
+    {
+        extraEdge[0] = (int) (nextRandom(randomState) % verticesCount);
+        extraEdge[1] = (int) (nextRandom(randomState) % verticesCount);
+    } while ((extraEdge[0] == extraEdge[1]) || (parent[extraEdge[0]] == extraEdge[1]) ||
+             (parent[extraEdge[1]] == extraEdge[0]));
+}
+
+/**
+ * @brief Writes a generated tree as a text graph file. Every vertex lists its children in its row, as long as they
+ * fit in MAX_ROW_LENGTH. A child which does not fit lists its parent in its own row instead, so wide vertices fill
+ * their rows to the limit and every row stays valid
+ * @param parent the parents of the tree, -1 for the root
+ * @param verticesCount
+ * @param extraEdge an edge added to the row of its first vertex, or NULL
+ * @param file the path of the graph file
+ * @return false when the file could not be written
+ * */
+bool writeGeneratedGraph(int *parent, int verticesCount, int *extraEdge, char *file)
+{
+    int *childrenCount = calloc(verticesCount, sizeof(int));
+    bool *listsParent = calloc(verticesCount, sizeof(bool));
+    int *childrenOffsets = calloc(verticesCount + 1, sizeof(int));
+    int *children = malloc(verticesCount * sizeof(int));
+    int rowCapacity = MAX_ROW_LENGTH - 1 - RESERVED_ROW_VERTICES * MAX_VERTEX_DIGITS;
+    char row[MAX_ROW_LENGTH + 1];
+    int vertexKey, edge, length;
+    FILE *fp;
+    bool success;
+
+    // group the children of every vertex, in increasing order
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        childrenOffsets[parent[vertexKey] + 1]++;
+    }
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        childrenOffsets[vertexKey + 1] += childrenOffsets[vertexKey];
+    }
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        if (parent[vertexKey] != -1)
+        {
+            children[childrenOffsets[parent[vertexKey]] + childrenCount[parent[vertexKey]]++] = vertexKey;
+        }
+    }
+
+    // decide which children do not fit in the row of their parent
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        length = 0;
+        for (edge = childrenOffsets[vertexKey]; edge < childrenOffsets[vertexKey + 1]; edge++)
+        {
+            length += snprintf(NULL, 0, " %d", children[edge]);
+            listsParent[children[edge]] = (length > rowCapacity);
+        }
+    }
+
+    fp = fopen(file, "w");
+    if (fp == NULL)
+    {
+        free(childrenCount);
+        free(listsParent);
+        free(childrenOffsets);
+        free(children);
+        return false;
+    }
+
+    fprintf(fp, "%d\n", verticesCount);
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        length = 0;
+        if (listsParent[vertexKey])
+        {
+            length += sprintf(row + length, " %d", parent[vertexKey]);
+        }
+        for (edge = childrenOffsets[vertexKey]; edge < childrenOffsets[vertexKey + 1]; edge++)
+        {
+            if (!listsParent[children[edge]])
+            {
+                length += sprintf(row + length, " %d", children[edge]);
+            }
+        }
+        if ((extraEdge != NULL) && (extraEdge[0] == vertexKey))
+        {
+            length += sprintf(row + length, " %d", extraEdge[1]);
+        }
+
+        // the row is written without its leading space
+        fprintf(fp, "%s\n", (length == 0) ? IS_LEAF : row + 1);
+    }
+
+    success = !ferror(fp);
+    if (fclose(fp) != 0)
+    {
+        success = false;
+    }
+
+    free(childrenCount);
+    free(listsParent);
+    free(childrenOffsets);
+    free(children);
+    return success;
+}
+
+/**
+ * @brief Generates a graph of a given kind and writes it as a text graph file. Prints an error message on failure
+ * @param kind the name of the kind of the graph
+ * @param verticesCount
+ * @param file the path of the graph file
+ * */
+bool generateGraphFile(char *kind, int verticesCount, char *file)
+{
+    const TreeGenerator *generator;
+    uint64_t randomState = GENERATOR_SEED;
+    int *parent;
+    int extraEdge[2];
+    int arity;
+    bool success;
+
+    // a cycle needs at least 3 vertices
+    generator = findTreeGenerator(kind, &arity);
+    if ((generator == NULL) || (verticesCount < 1) || (generator->addsExtraEdge && (verticesCount < 3)))
+    {
+        fprintf(stderr, "%s", INVALID_INPUT_MSG);
+        return false;
+    }
+
+    parent = malloc(verticesCount * sizeof(int));
+    generator->generate(parent, verticesCount, arity, &randomState);
+    if (generator->addsExtraEdge)
+    {
+        findExtraEdge(parent, verticesCount, &randomState, extraEdge);
+    }
+
+    success = writeGeneratedGraph(parent, verticesCount, generator->addsExtraEdge ? extraEdge : NULL, file);
+    if (!success)
+    {
         fprintf(stderr, "%s", INVALID_USAGE_MSG);
+    }
+
+    free(parent);
+    return success;
+}
+
+/**
+ * @brief Generates a graph file of a given kind and size.
+ * Expects the arguments --generate <Tree Kind> <Vertices Count> <Graph File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runGenerateMode(char *argv[])
+{
+    long verticesCount;
+
+    if (nonNumerical(argv[MODE_SECOND_ARG_INDEX]) != 0)
+    {
+        fprintf(stderr, "%s", INVALID_INPUT_MSG);
+        return EXIT_FAILURE;
+    }
+
+    // strtol saturates to LONG_MAX, so a count too large for a long is rejected as well
+    verticesCount = strtol(argv[MODE_SECOND_ARG_INDEX], NULL, 10);
+    if (verticesCount > INT_MAX)
+    {
+        fprintf(stderr, "%s", INVALID_INPUT_MSG);
+        return EXIT_FAILURE;
+    }
+
+    return generateGraphFile(argv[MODE_FIRST_ARG_INDEX], (int) verticesCount,
+                             argv[MODE_SECOND_ARG_INDEX + 1]) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Find the time in seconds since some fixed point, for measuring durations
+ * */
+double getSeconds()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Times every phase of the analysis of a graph file, and prints them as a line of the benchmark output.
+ * Phases which were not reached are left empty, and the result is "not-tree" when the graph is not a tree, or
+ * "invalid" when the file could not be read or is not in the graph format
+ * @param kind the name of the kind of the graph, printed in the line
+ * @param verticesCount
+ * @param file the path of the graph file
+ * */
+void runBenchmark(char *kind, int verticesCount, char *file)
+{
+    GraphRows rows;
+    Graph *graph;
+    TreeAnalysis *analysis;
+    QueryEngine engine;
+    FILE *nullOut;
+    uint64_t randomState = GENERATOR_SEED;
+    int graphSize = 0;
+    bool isValid;
+    double start, parseTime, buildTime, isTreeTime, distancesTime, indexTime, queriesTime;
+    int i;
+
+    printf("%s,%d,", kind, verticesCount);
+
+    start = getSeconds();
+    if (!parseGraphFile(&rows, file, 0, true, stderr))
+    {
+        parseTime = getSeconds() - start;
+        freeGraphRows(&rows);
+
+        // the file is parsed again without the tree checks, a file which passes is in the graph format
+        nullOut = fopen("/dev/null", "w");
+        isValid = (nullOut != NULL) && parseGraphFile(&rows, file, 0, false, nullOut);
+        freeGraphRows(&rows);
+        if (nullOut != NULL)
+        {
+            fclose(nullOut);
+        }
+
+        printf("%.6f,,,,,,%s\n", parseTime, isValid ? "not-tree" : "invalid");
+        return;
+    }
+    graphSize = rows.verticesCount;
+    parseTime = getSeconds() - start;
+
+    start = getSeconds();
+    graph = initGraph(graphSize);
+    attachEdges(graph, &rows);
+    freeGraphRows(&rows);
+    buildTime = getSeconds() - start;
+
+    start = getSeconds();
+    analysis = initTreeAnalysis(graphSize);
+    if (!isTree(graph, analysis))
+    {
+        printf("%.6f,%.6f,%.6f,,,,not-tree\n", parseTime, buildTime, getSeconds() - start);
+        freeTreeAnalysis(&analysis);
+        freeGraph(&graph);
+        return;
+    }
+    isTreeTime = getSeconds() - start;
+
+    start = getSeconds();
+    findTreeDistanceInfo(graph, analysis);
+    distancesTime = getSeconds() - start;
+
+    start = getSeconds();
+    initQueryEngine(&engine, buildTreeIndex(graph, analysis));
+    indexTime = getSeconds() - start;
+
+    // the paths are printed, but not to the terminal
+    nullOut = fopen("/dev/null", "w");
+    start = getSeconds();
+    for (i = 0; (i < BENCHMARK_QUERIES_COUNT) && (nullOut != NULL); i++)
+    {
+        printTreePath(&engine, (int) (nextRandom(&randomState) % graphSize),
+                      (int) (nextRandom(&randomState) % graphSize), nullOut);
+    }
+    queriesTime = getSeconds() - start;
+
+    printf("%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,ok\n", parseTime, buildTime, isTreeTime, distancesTime, indexTime,
+           queriesTime);
+
+    if (nullOut != NULL)
+    {
+        fclose(nullOut);
+    }
+    freeQueryEngine(&engine);
+    freeTreeAnalysis(&analysis);
+    freeGraph(&graph);
+}
+
+/**
+ * @brief Generates trees of a given kind of increasing sizes, and prints the time of every phase of their analysis
+ * as comma separated values, one line per tree. The sizes grow 10 times from 1000 up to a given maximal size,
+ * which is at least 1000.
+ * Expects the arguments --benchmark <Tree Kind> <Max Vertices Count> <Graph File Path>, where the graph file
+ * is overwritten with every generated tree
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runBenchmarkMode(char *argv[])
+{
+    long maxVerticesCount;
+    long verticesCount;
+
+    if (nonNumerical(argv[MODE_SECOND_ARG_INDEX]) != 0)
+    {
+        fprintf(stderr, "%s", INVALID_INPUT_MSG);
+        return EXIT_FAILURE;
+    }
+    maxVerticesCount = strtol(argv[MODE_SECOND_ARG_INDEX], NULL, 10);
+    if (maxVerticesCount > INT_MAX)
+    {
+        fprintf(stderr, "%s", INVALID_INPUT_MSG);
+        return EXIT_FAILURE;
+    }
+
+    // a maximal size below the smallest benchmarked tree would print the header only
+    if (maxVerticesCount < BENCHMARK_MIN_VERTICES)
+    {
+        fprintf(stderr, "%s", BENCHMARK_USAGE_MSG);
+        return EXIT_FAILURE;
+    }
+
+    printf("%s", BENCHMARK_HEADER);
+    for (verticesCount = BENCHMARK_MIN_VERTICES; verticesCount <= maxVerticesCount;
+         verticesCount *= BENCHMARK_SIZE_FACTOR)
+    {
+        if (!generateGraphFile(argv[MODE_FIRST_ARG_INDEX], (int) verticesCount, argv[MODE_SECOND_ARG_INDEX + 1]))
+        {
+            return EXIT_FAILURE;
+        }
+
+        runBenchmark(argv[MODE_FIRST_ARG_INDEX], (int) verticesCount, argv[MODE_SECOND_ARG_INDEX + 1]);
+        fflush(stdout);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Initialize the measurements of a run, when they are enabled by the TREE_ANALYZER_DIAGNOSTICS environment
+ * variable
+ * @return the measurements, or NULL when diagnostics are disabled
+ * */
+Diagnostics *initDiagnostics()
+{
+    char *output = getenv(DIAGNOSTICS_ENV_VAR);
+    Diagnostics *diagnostics;
+
+    if ((output == NULL) || (*output == '\0'))
+    {
+        return NULL;
+    }
+
+    diagnostics = calloc(1, sizeof(Diagnostics));
+    diagnostics->output = output;
+    return diagnostics;
+}
+
+/**
+ * @brief Records the wall time of a phase which ended now. Does nothing when diagnostics are disabled
+ * @param diagnostics the measurements of the run, or NULL
+ * @param name the name of the phase
+ * @param start the time the phase started at, as returned by getSeconds
+ * */
+void recordPhase(Diagnostics *diagnostics, char *name, double start)
+{
+    if ((diagnostics == NULL) || (diagnostics->phasesCount == MAX_DIAGNOSTICS_PHASES))
+    {
+        return;
+    }
+
+    diagnostics->phases[diagnostics->phasesCount].name = name;
+    diagnostics->phases[diagnostics->phasesCount].seconds = getSeconds() - start;
+    diagnostics->phasesCount++;
+}
+
+/**
+ * @brief Find the maximal resident memory of the process so far, in kilobytes
+ * */
+long getPeakRssKb()
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief Prints the measurements of a run to stderr, or writes them to a json file, so the output of the run is not
+ * changed. Does nothing when diagnostics are disabled
+ * @param diagnostics the measurements of the run, or NULL
+ * @param graph the graph of the run, or NULL when it was not built
+ * */
+void reportDiagnostics(Diagnostics *diagnostics, Graph *graph)
+{
+    bool toStderr;
+    FILE *out;
+    int i;
+
+    if (diagnostics == NULL)
+    {
+        return;
+    }
+
+    if (graph != NULL)
+    {
+        diagnostics->vertexBytes = graph->arena.allocatedBytes;
+    }
+
+    toStderr = (strcmp(diagnostics->output, DIAGNOSTICS_TO_STDERR) == 0);
+    out = toStderr ? stderr : fopen(diagnostics->output, "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "%s", DIAGNOSTICS_WRITE_FAILED_MSG);
+        return;
+    }
+
+    if (toStderr)
+    {
+        for (i = 0; i < diagnostics->phasesCount; i++)
+        {
+            fprintf(out, "%s: %.6f s\n", diagnostics->phases[i].name, diagnostics->phases[i].seconds);
+        }
+        fprintf(out, "BFS Passes: %d\n", diagnostics->bfsPasses);
+        fprintf(out, "Vertex Bytes: %zu\n", diagnostics->vertexBytes);
+        fprintf(out, "Line Bytes: %zu\n", diagnostics->lineBytes);
+        fprintf(out, "Peak RSS: %ld KB\n", getPeakRssKb());
+        return;
+    }
+
+    fprintf(out, "{\"phases\": {");
+    for (i = 0; i < diagnostics->phasesCount; i++)
+    {
+        fprintf(out, "%s\"%s\": %.6f", (i == 0) ? "" : ", ", diagnostics->phases[i].name,
+                diagnostics->phases[i].seconds);
+    }
+    fprintf(out, "}, \"bfsPasses\": %d, \"vertexBytes\": %zu, \"lineBytes\": %zu, \"peakRssKb\": %ld}\n",
+            diagnostics->bfsPasses, diagnostics->vertexBytes, diagnostics->lineBytes, getPeakRssKb());
+
+    if (fclose(out) != 0)
+    {
+        fprintf(stderr, "%s", DIAGNOSTICS_WRITE_FAILED_MSG);
+    }
+}
+
+/**
+ * @brief Release the memory allocated to the measurements of a run
+ * @param diagnosticsPtr
+ * */
+void freeDiagnostics(Diagnostics **diagnosticsPtr)
+{
+    free(*diagnosticsPtr);
+    *diagnosticsPtr = NULL;
+}
+
+/**
+ * @brief Reads the jobs of a batch from a manifest, one job per line in the format <Graph File Path> <First Vertex>
+ * <Second Vertex>. Empty lines are skipped, and any other line which is not in this format is an invalid job
+ * @param file the path of the manifest
+ * @param batch filled with the jobs of the manifest
+ * @return false when the manifest can not be read. An error message is printed
+ * */
+bool readManifest(char *file, Batch *batch)
+{
+    FILE *fp;
+    char line[MAX_ROW_LENGTH + 1];
+    char *fields[VALID_ARG_COUNT];
+    int capacity = BATCH_FIRST_JOBS_CAPACITY;
+    int fieldsCount;
+    BatchJob *job;
+
+    fp = fopen(file, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "%s", BATCH_USAGE_MSG);
+        return false;
+    }
+
+    batch->jobs = malloc(capacity * sizeof(BatchJob));
+    batch->jobsCount = 0;
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        // remove line terminators
+        line[strcspn(line, "\r\n")] = '\0';
+
+        // split the line, keeping one more field than expected to detect extra fields
+        fieldsCount = 0;
+        fields[fieldsCount] = strtok(line, MANIFEST_SEPARATORS);
+        while ((fields[fieldsCount] != NULL) && (fieldsCount < VALID_ARG_COUNT - 1))
+        {
+            fields[++fieldsCount] = strtok(NULL, MANIFEST_SEPARATORS);
+        }
+        if (fieldsCount == 0)
+        {
+            continue;
+        }
+
+        if (batch->jobsCount == capacity)
+        {
+            capacity *= 2;
+            batch->jobs = realloc(batch->jobs, capacity * sizeof(BatchJob));
+        }
+        job = &batch->jobs[batch->jobsCount++];
+
+        // the vertices are validated as the vertices of the arguments of the default analysis
+        job->file = strdup(fields[0]);
+        job->valid = (fieldsCount == VALID_ARG_COUNT - 1) && (fields[fieldsCount] == NULL) &&
+                     (nonNumerical(fields[1]) == 0) && (nonNumerical(fields[2]) == 0);
+        job->uVertexKey = job->valid ? (int) strtod(fields[1], NULL) : 0;
+        job->vVertexKey = job->valid ? (int) strtod(fields[2], NULL) : 0;
+        job->result = NULL;
+        job->resultSize = 0;
+        job->succeeded = false;
+    }
+
+    fclose(fp);
+    return true;
+}
+
+/**
+ * @brief Prints a json string, escaping the characters which can not appear in it as they are
+ * @param out
+ * @param str
+ * @param length the amount of characters of the string to print
+ * */
+void printJsonString(FILE *out, char *str, size_t length)
+{
+    size_t i;
+
+    fputc('"', out);
+    for (i = 0; i < length; i++)
+    {
+        if ((str[i] == '"') || (str[i] == '\\'))
+        {
+            fprintf(out, "\\%c", str[i]);
+        }
+        else if ((unsigned char) str[i] < ' ')
+        {
+            fprintf(out, "\\u%04x", (unsigned char) str[i]);
+        }
+        else
+        {
+            fputc(str[i], out);
+        }
+    }
+    fputc('"', out);
+}
+
+/**
+ * @brief Analyzes the graph of a single job, and writes the result as a json line. The result holds the output of
+ * the default analysis, or the error message it would print
+ * @param job
+ * @param jobIndex the line of the job among the jobs of the manifest
+ * @param worker the buffers of the thread running the job
+ * */
+void runBatchJob(BatchJob *job, int jobIndex, BatchWorker *worker)
+{
+    FILE *out = open_memstream(&job->result, &job->resultSize);
+    char *errorMsg = NULL;
+    size_t errorSize = 0;
+    FILE *errorOut = open_memstream(&errorMsg, &errorSize);
+    TreeAnalysis *analysis;
+    Graph *graph;
+    int maxVertexKey = (job->uVertexKey > job->vVertexKey) ? job->uVertexKey : job->vVertexKey;
+    int pathLength;
+    int i;
+
+    fprintf(out, "{\"job\": %d, \"file\": ", jobIndex);
+    printJsonString(out, job->file, strlen(job->file));
+
+    if (!job->valid)
+    {
+        fprintf(errorOut, "%s", INVALID_INPUT_MSG);
+    }
+    else if (readGraph(job->file, maxVertexKey, &graph, NULL, errorOut))
+    {
+        // the buffers of the previous job are reused when they are large enough
+        if (graph->verticesCount > worker->capacity)
+        {
+            if (worker->analysis != NULL)
+            {
+                freeTreeAnalysis(&worker->analysis);
+            }
+            worker->analysis = initTreeAnalysis(graph->verticesCount);
+            worker->capacity = graph->verticesCount;
+
+            // the jobs already run in parallel, so every traversal is sequential
+            worker->analysis->threadCount = 1;
+        }
+        analysis = worker->analysis;
+
+        if (!isTree(graph, analysis))
+        {
+            fprintf(errorOut, "%s", GRAPH_NOT_TREE_MSG);
+        }
+        else
+        {
+            findTreeDistanceInfo(graph, analysis);
+            fprintf(out, ", \"u\": %d, \"v\": %d, \"root\": %d, \"vertices\": %d, \"edges\": %d, "
+                         "\"minBranchLength\": %lld, \"maxBranchLength\": %lld, \"diameter\": %lld, \"path\": [",
+                    job->uVertexKey, job->vVertexKey, graph->root, graph->verticesCount, graph->edgesCount,
+                    analysis->minBranchLength, analysis->maxBranchLength, analysis->diameter);
+
+            pathLength = findShortestPath(analysis, graph->verticesCount, job->uVertexKey, job->vVertexKey,
+                                          analysis->scratch);
+            for (i = 0; i < pathLength; i++)
+            {
+                fprintf(out, "%s%d", (i == 0) ? "" : ", ", analysis->scratch[i]);
+            }
+            fprintf(out, "], \"pathLength\": %lld",
+                    graph->weighted ? findWeightedPathLength(analysis, analysis->scratch, pathLength) : pathLength - 1);
+            job->succeeded = true;
+        }
+        freeGraph(&graph);
+    }
+
+    // the error message is printed without its line terminator
+    fclose(errorOut);
+    if (errorSize > 0)
+    {
+        fprintf(out, ", \"error\": ");
+        printJsonString(out, errorMsg, strcspn(errorMsg, "\n"));
+    }
+    free(errorMsg);
+
+    fprintf(out, "}\n");
+    fclose(out);
+}
+
+/**
+ * @brief Runs the jobs of a batch on a thread, until no job is left. Every job is taken by a single thread
+ * @param batchArgs the batch
+ * @param threadIndex
+ * @param threadCount
+ * */
+void batchTask(void *batchArgs, int threadIndex, int threadCount)
+{
+    Batch *batch = batchArgs;
+    int jobIndex;
+
+    (void) threadCount;
+
+    jobIndex = __atomic_fetch_add(&batch->nextJob, 1, __ATOMIC_RELAXED);
+    while (jobIndex < batch->jobsCount)
+    {
+        runBatchJob(&batch->jobs[jobIndex], jobIndex, &batch->workers[threadIndex]);
+        jobIndex = __atomic_fetch_add(&batch->nextJob, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Runs the default analysis on every graph of a manifest in parallel, and prints the results as json lines
+ * in the order of the manifest. A job which fails does not stop the other jobs.
+ * Expects the arguments --batch <Manifest File Path>
+ * @param argv
+ * @return the exit code of the program, a failure when any of the jobs failed
+ * */
+int runBatchMode(char *argv[])
+{
+    Batch batch;
+    ThreadPool *pool;
+    int threadCount;
+    bool success = true;
+    int i;
+
+    if (!readManifest(argv[MODE_FIRST_ARG_INDEX], &batch))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // a thread without a job would only hold idle buffers
+    threadCount = getThreadCount();
+    if (threadCount > batch.jobsCount)
+    {
+        threadCount = (batch.jobsCount > 0) ? batch.jobsCount : 1;
+    }
+
+    batch.nextJob = 0;
+    batch.workers = calloc(threadCount, sizeof(BatchWorker));
+    pool = initThreadPool(threadCount);
+    runParallel(pool, batchTask, &batch);
+    freeThreadPool(&pool);
+
+    for (i = 0; i < batch.jobsCount; i++)
+    {
+        fwrite(batch.jobs[i].result, 1, batch.jobs[i].resultSize, stdout);
+        success = success && batch.jobs[i].succeeded;
+        free(batch.jobs[i].result);
+        free(batch.jobs[i].file);
+    }
+
+    for (i = 0; i < threadCount; i++)
+    {
+        if (batch.workers[i].analysis != NULL)
+        {
+            freeTreeAnalysis(&batch.workers[i].analysis);
+        }
+    }
+    free(batch.workers);
+    free(batch.jobs);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Find the representative of the set of a vertex while other threads merge sets. Every vertex on the way
+ * is linked to its grandparent with compare and swap, which fails harmlessly when another thread changed the link
+ * @param sets
+ * @param vertexKey
+ * */
+int findSetConcurrent(DisjointSets *sets, int vertexKey)
+{
+    int parent = __atomic_load_n(&sets->parent[vertexKey], __ATOMIC_ACQUIRE);
+    int grandparent;
+
+    while (parent != vertexKey)
+    {
+        grandparent = __atomic_load_n(&sets->parent[parent], __ATOMIC_ACQUIRE);
+        __atomic_compare_exchange_n(&sets->parent[vertexKey], &parent, grandparent, false, __ATOMIC_RELEASE,
+                                    __ATOMIC_RELAXED);
+        vertexKey = parent;
+        parent = __atomic_load_n(&sets->parent[vertexKey], __ATOMIC_ACQUIRE);
+    }
+
+    return vertexKey;
+}
+
+/**
+ * @brief Merge the sets of two vertices while other threads merge sets, without locks. The representative with the
+ * smaller key is linked under the other one with compare and swap, so the links never form a cycle, and the merge
+ * is retried when another thread linked it first. The sizes of the sets are not kept
+ * @param sets
+ * @param uVertexKey
+ * @param vVertexKey
+ * @return false when the vertices are already in the same set
+ * */
+bool unionSetsConcurrent(DisjointSets *sets, int uVertexKey, int vVertexKey)
+{
+    int uRoot, vRoot, temp;
+
+    while (true)
+    {
+        uRoot = findSetConcurrent(sets, uVertexKey);
+        vRoot = findSetConcurrent(sets, vVertexKey);
+        if (uRoot == vRoot)
+        {
+            return false;
+        }
+
+        if (uRoot > vRoot)
+        {
+            temp = uRoot;
+            uRoot = vRoot;
+            vRoot = temp;
+        }
+
+        // fails when the representative was linked by another thread since it was found
+        temp = uRoot;
+        if (__atomic_compare_exchange_n(&sets->parent[uRoot], &temp, vRoot, false, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED))
+        {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Merges the components of the edges of a range of vertices. Runs over the adjacency lists of the graph,
+ * once the whole file was parsed and its edges attached, and not while the rows are read. An edge which joins a
+ * component to itself closes a cycle. Every edge is added once, from its end with the smaller key, and a self loop
+ * twice
+ * @param forestArgs the forest
+ * @param threadIndex
+ * @param threadCount
+ * */
+void forestUnionTask(void *forestArgs, int threadIndex, int threadCount)
+{
+    Forest *forest = forestArgs;
+    Vertex *temp;
+    long start, end, vertexIndex;
+
+    getThreadRange(forest->graph->verticesCount, threadIndex, threadCount, &start, &end);
+    for (vertexIndex = start; vertexIndex < end; vertexIndex++)
+    {
+        for (temp = forest->graph->listOfAdjacent[vertexIndex]; temp != NULL; temp = temp->next)
+        {
+            if ((vertexIndex <= temp->vertexKey) &&
+                (!unionSetsConcurrent(forest->sets, (int) vertexIndex, temp->vertexKey)))
+            {
+                __atomic_store_n(&forest->cycleFound, true, __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Links every vertex of a range directly to the representative of its component, after all the edges were
+ * added
+ * @param forestArgs the forest
+ * @param threadIndex
+ * @param threadCount
+ * */
+void forestLabelTask(void *forestArgs, int threadIndex, int threadCount)
+{
+    Forest *forest = forestArgs;
+    long start, end, vertexIndex;
+
+    getThreadRange(forest->graph->verticesCount, threadIndex, threadCount, &start, &end);
+    for (vertexIndex = start; vertexIndex < end; vertexIndex++)
+    {
+        __atomic_store_n(&forest->sets->parent[vertexIndex], findSetConcurrent(forest->sets, (int) vertexIndex),
+                         __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Orders components from the largest to the smallest, and components of the same size by their first leaf
+ * @param first
+ * @param second
+ * */
+int compareComponents(const void *first, const void *second)
+{
+    const ForestComponent *firstComponent = first;
+    const ForestComponent *secondComponent = second;
+
+    if (firstComponent->verticesCount != secondComponent->verticesCount)
+    {
+        return (firstComponent->verticesCount > secondComponent->verticesCount) ? -1 : 1;
+    }
+
+    return (firstComponent->root > secondComponent->root) - (firstComponent->root < secondComponent->root);
+}
+
+/**
+ * @brief Lists the components of a forest whose vertices are linked to their representatives, sorted by size.
+ * Every component starts at the leaf with the smallest key, and gets a range of the traversal order buffer
+ * @param forest
+ * */
+void findForestComponents(Forest *forest)
+{
+    Graph *graph = forest->graph;
+    int *componentOf = malloc(graph->verticesCount * sizeof(int));
+    ForestComponent *component;
+    int offset = 0;
+    int vertexIndex;
+    int i;
+
+    // every representative is a component
+    forest->componentsCount = 0;
+    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    {
+        if (forest->sets->parent[vertexIndex] == vertexIndex)
+        {
+            componentOf[vertexIndex] = forest->componentsCount++;
+        }
+    }
+
+    forest->components = malloc(forest->componentsCount * sizeof(ForestComponent));
+    for (i = 0; i < forest->componentsCount; i++)
+    {
+        forest->components[i].root = -1;
+        forest->components[i].verticesCount = 0;
+    }
+
+    // every component of a forest is a tree, so it has a leaf, or a single vertex
+    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    {
+        component = &forest->components[componentOf[forest->sets->parent[vertexIndex]]];
+        component->verticesCount++;
+        if ((component->root == -1) && (getVertexDeg(graph, vertexIndex) <= 1))
+        {
+            component->root = vertexIndex;
+        }
+    }
+    free(componentOf);
+
+    qsort(forest->components, forest->componentsCount, sizeof(ForestComponent), compareComponents);
+    for (i = 0; i < forest->componentsCount; i++)
+    {
+        forest->components[i].offset = offset;
+        offset += forest->components[i].verticesCount;
+    }
+}
+
+/**
+ * @brief Traverses a component of a forest from a given vertex, summing the weights of the edges. The vertices of
+ * the component must have a negative length before the traversal
+ * @param graph
+ * @param startVertexKey
+ * @param length filled with the distance of every vertex of the component from the start vertex
+ * @param order filled with the vertices of the component in the order they were reached
+ * @return the amount of vertices in the component
+ * */
+int traverseComponent(Graph *graph, int startVertexKey, long long *length, int *order)
+{
+    int reachedCount = 1;
+    int i;
+    Vertex *temp;
+
+    length[startVertexKey] = 0;
+    order[0] = startVertexKey;
+
+    // the reached vertices are the queue of the traversal
+    for (i = 0; i < reachedCount; i++)
+    {
+        for (temp = graph->listOfAdjacent[order[i]]; temp != NULL; temp = temp->next)
+        {
+            if (length[temp->vertexKey] < 0)
+            {
+                length[temp->vertexKey] = length[order[i]] + temp->weight;
+                order[reachedCount++] = temp->vertexKey;
+            }
+        }
+    }
+
+    return reachedCount;
+}
+
+/**
+ * @brief Finds the root, the branch lengths and the diameter of a component of a forest, as the default analysis
+ * finds them for a tree: the root is the top ancestor of the first leaf, and the farthest vertex from the root is an
+ * end of a diameter
+ * @param forest
+ * @param component a component whose root is still its first leaf
+ * */
+void analyzeComponent(Forest *forest, ForestComponent *component)
+{
+    Graph *graph = forest->graph;
+    long long *length = forest->length;
+    int *order = forest->order + component->offset;
+    bool leafFound = false;
+    int farthest;
+    int vertexKey;
+    int i;
+
+    // climb from the leaf to the vertex without ancestors
+    while (graph->listOfAncestors[component->root] != NULL)
+    {
+        component->root = graph->listOfAncestors[component->root]->vertexKey;
+    }
+
+    traverseComponent(graph, component->root, length, order);
+
+    // goes over each leaf and find the ones with the minimal and maximal distance from the root
+    farthest = component->root;
+    component->minBranchLength = 0;
+    component->maxBranchLength = 0;
+    for (i = 1; i < component->verticesCount; i++)
+    {
+        vertexKey = order[i];
+        if (length[vertexKey] > length[farthest])
+        {
+            farthest = vertexKey;
+        }
+
+        if (getVertexDeg(graph, vertexKey) != 1)
+        {
+            continue;
+        }
+
+        if (length[vertexKey] > component->maxBranchLength)
+        {
+            component->maxBranchLength = length[vertexKey];
+        }
+
+        if ((!leafFound) || (length[vertexKey] < component->minBranchLength))
+        {
+            component->minBranchLength = length[vertexKey];
+        }
+        leafFound = true;
+    }
+
+    // traverse again from the end of a diameter
+    for (i = 0; i < component->verticesCount; i++)
+    {
+        length[order[i]] = -1;
+    }
+    traverseComponent(graph, farthest, length, order);
+
+    component->diameter = 0;
+    for (i = 0; i < component->verticesCount; i++)
+    {
+        if (length[order[i]] > component->diameter)
+        {
+            component->diameter = length[order[i]];
+        }
+    }
+}
+
+/**
+ * @brief Analyzes the components of a forest on a thread, until no component is left. The components are taken
+ * from the largest, so the threads end close to each other
+ * @param forestArgs the forest
+ * @param threadIndex
+ * @param threadCount
+ * */
+void forestComponentsTask(void *forestArgs, int threadIndex, int threadCount)
+{
+    Forest *forest = forestArgs;
+    int componentIndex;
+
+    (void) threadIndex;
+    (void) threadCount;
+
+    componentIndex = __atomic_fetch_add(&forest->nextComponent, 1, __ATOMIC_RELAXED);
+    while (componentIndex < forest->componentsCount)
+    {
+        analyzeComponent(forest, &forest->components[componentIndex]);
+        componentIndex = __atomic_fetch_add(&forest->nextComponent, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Prints the analysis of every component of a forest, from the largest to the smallest
+ * @param forest
+ * */
+void printForestComponents(Forest *forest)
+{
+    ForestComponent *component;
+    int i;
+
+    printf("%s%d\n", COMPONENTS_COUNT_MSG, forest->componentsCount);
+    for (i = 0; i < forest->componentsCount; i++)
+    {
+        component = &forest->components[i];
+        printf("%s%d:\n", COMPONENT_MSG, i + 1);
+        printf("%s%d\n", ROOT_VERTEX_MSG, component->root);
+        printf("%s%d\n", VERTICES_COUNT_MSG, component->verticesCount);
+        printf("%s%d\n", EDGES_COUNT_MSG, component->verticesCount - 1);
+        printf("%s%lld\n", MINIMAL_BRACH_LENGTH_MSG, component->minBranchLength);
+        printf("%s%lld\n", MAXIMAL_BRACH_LENGTH_MSG, component->maxBranchLength);
+        printf("%s%lld\n", DIAMETER_LENGTH_MSG, component->diameter);
+    }
+}
+
+/**
+ * @brief Analyzes every connected component of a forest as a tree, and prints the components sorted by size.
+ * Once the file is parsed and the graph built, the components are found with a concurrent union-find over ranges of
+ * the adjacency lists in parallel, and then analyzed in parallel. Expects the arguments --forest <Graph File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runForestMode(char *argv[])
+{
+    GraphRows rows;
+    Forest forest;
+    ThreadPool *pool;
+    int graphSize;
+
+    if (!parseGraphFile(&rows, argv[MODE_FIRST_ARG_INDEX], 0, false, stderr))
+    {
+        freeGraphRows(&rows);
+        return EXIT_FAILURE;
+    }
+
+    graphSize = rows.verticesCount;
+    forest.graph = initGraph(graphSize);
+    attachEdges(forest.graph, &rows);
+    freeGraphRows(&rows);
+
+    // label the components, a single edge closing a cycle means the graph is not a forest
+    forest.sets = initDisjointSets(graphSize);
+    forest.cycleFound = false;
+    pool = initThreadPool(getThreadCount());
+    runParallel(pool, forestUnionTask, &forest);
+    if (forest.cycleFound)
+    {
+        fprintf(stderr, "%s", GRAPH_NOT_FOREST_MSG);
+        freeThreadPool(&pool);
+        freeDisjointSets(&forest.sets);
+        freeGraph(&forest.graph);
+        return EXIT_FAILURE;
+    }
+    runParallel(pool, forestLabelTask, &forest);
+    findForestComponents(&forest);
+
+    // every length starts negative, which marks the vertex as not reached
+    forest.length = malloc(graphSize * sizeof(long long));
+    memset(forest.length, 0xFF, graphSize * sizeof(long long));
+    forest.order = malloc(graphSize * sizeof(int));
+    forest.nextComponent = 0;
+    runParallel(pool, forestComponentsTask, &forest);
+    freeThreadPool(&pool);
+
+    printForestComponents(&forest);
+
+    free(forest.length);
+    free(forest.order);
+    free(forest.components);
+    freeDisjointSets(&forest.sets);
+    freeGraph(&forest.graph);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Find the key a vertex had in the input, before the graph was relabeled
+ * @param graph
+ * @param vertexKey
+ * */
+int getOriginalKey(Graph *graph, int vertexKey)
+{
+    return (graph->originalKeys == NULL) ? vertexKey : graph->originalKeys[vertexKey];
+}
+
+/**
+ * @brief Find the order a bfs from the root of a tree reaches its vertices in, and the parent of every vertex.
+ * Every vertex but the root is reached from its parent only, so no vertex is marked as visited
+ * @param graph a tree whose root is set
+ * @param order filled with the vertices in the order they are reached
+ * @param parent filled with the parent of every vertex, -1 for the root
+ * */
+void findBfsOrder(Graph *graph, int *order, int *parent)
+{
+    int reachedCount = 1;
+    int i;
+    Vertex *temp;
+
+    order[0] = graph->root;
+    parent[graph->root] = -1;
+
+    for (i = 0; i < reachedCount; i++)
+    {
+        for (temp = graph->listOfAdjacent[order[i]]; temp != NULL; temp = temp->next)
+        {
+            if (temp->vertexKey != parent[order[i]])
+            {
+                parent[temp->vertexKey] = order[i];
+                order[reachedCount++] = temp->vertexKey;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Find the reverse Cuthill-McKee order of the vertices of a tree: a bfs from a vertex of minimal degree,
+ * which reaches the neighbors of every vertex from the lowest degree, reversed. The neighbors are sorted by degree
+ * for all the vertices at once, by adding every vertex to the lists of its neighbors in the order of the degrees
+ * @param graph a tree
+ * @param order filled with the vertices in reverse Cuthill-McKee order
+ * */
+void findCuthillMcKeeOrder(Graph *graph, int *order)
+{
+    int verticesCount = graph->verticesCount;
+    int *degree = malloc(verticesCount * sizeof(int));
+    int *byDegree = malloc(verticesCount * sizeof(int));
+    int *offsets = calloc(verticesCount + 1, sizeof(int));
+    int *sortedAdjacency = malloc(2 * (size_t) graph->edgesCount * sizeof(int) + sizeof(int));
+    int *parent = degree;
+    int reachedCount = 1;
+    int vertexIndex, i, temp;
+    Vertex *neighbor;
+
+    // counting sort of the vertices by their degree
+    for (vertexIndex = 0; vertexIndex < verticesCount; vertexIndex++)
+    {
+        degree[vertexIndex] = getVertexDeg(graph, vertexIndex);
+        offsets[degree[vertexIndex] + 1]++;
+    }
+    for (i = 0; i < verticesCount; i++)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+    for (vertexIndex = 0; vertexIndex < verticesCount; vertexIndex++)
+    {
+        byDegree[offsets[degree[vertexIndex]]++] = vertexIndex;
+    }
+
+    // the neighbors of every vertex, from the lowest degree. The offsets become the ends of the lists
+    offsets[0] = 0;
+    for (vertexIndex = 0; vertexIndex < verticesCount; vertexIndex++)
+    {
+        offsets[vertexIndex + 1] = offsets[vertexIndex] + degree[vertexIndex];
+    }
+    for (i = 0; i < verticesCount; i++)
+    {
+        for (neighbor = graph->listOfAdjacent[byDegree[i]]; neighbor != NULL; neighbor = neighbor->next)
+        {
+            sortedAdjacency[offsets[neighbor->vertexKey]++] = byDegree[i];
+        }
+    }
+
+    // bfs from a vertex of minimal degree, the degrees are not needed anymore
+    order[0] = byDegree[0];
+    parent[byDegree[0]] = -1;
+    for (i = 0; i < reachedCount; i++)
+    {
+        vertexIndex = order[i];
+        for (temp = (vertexIndex == 0) ? 0 : offsets[vertexIndex - 1]; temp < offsets[vertexIndex]; temp++)
+        {
+            if (sortedAdjacency[temp] != parent[vertexIndex])
+            {
+                parent[sortedAdjacency[temp]] = vertexIndex;
+                order[reachedCount++] = sortedAdjacency[temp];
+            }
+        }
+    }
+
+    // reverse the order
+    for (i = 0; i < verticesCount / 2; i++)
+    {
+        temp = order[i];
+        order[i] = order[verticesCount - 1 - i];
+        order[verticesCount - 1 - i] = temp;
+    }
+
+    free(degree);
+    free(byDegree);
+    free(offsets);
+    free(sortedAdjacency);
+}
+
+/**
+ * @brief Relabels the vertices of a tree in bfs order from its root, or in reverse Cuthill-McKee order, so close
+ * vertices have close keys. The adjacency lists are rebuilt in the new order, so the lists of consecutive vertices
+ * are next to each other in memory. The only vertex without an ancestor is the root, so the root is not changed
+ * @param graphPtr a tree. Replaced by the relabeled tree, which keeps the original keys for printing
+ * @param reverseCuthillMcKee whenever to use reverse Cuthill-McKee order instead of bfs order
+ * @return the new key of every vertex, to be released by the caller
+ * */
+int *relabelGraph(Graph **graphPtr, bool reverseCuthillMcKee)
+{
+    Graph *graph = *graphPtr;
+    Graph *relabeled = initGraph(graph->verticesCount);
+    int *originalKeys = malloc(graph->verticesCount * sizeof(int));
+    int *newKeys = malloc(graph->verticesCount * sizeof(int));
+    int *parent = malloc(graph->verticesCount * sizeof(int));
+    int vertexIndex;
+    Vertex *temp, *newVertex, **tail;
+
+    setRootVertexKey(graph);
+    findBfsOrder(graph, originalKeys, parent);
+    if (reverseCuthillMcKee)
+    {
+        findCuthillMcKeeOrder(graph, originalKeys);
+    }
+    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    {
+        newKeys[originalKeys[vertexIndex]] = vertexIndex;
+    }
+
+    // copy the lists in the new order, the ancestor of every vertex is its parent from the root
+    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    {
+        tail = &relabeled->listOfAdjacent[vertexIndex];
+        for (temp = graph->listOfAdjacent[originalKeys[vertexIndex]]; temp != NULL; temp = temp->next)
+        {
+            newVertex = createVertex(relabeled, newKeys[temp->vertexKey]);
+            newVertex->weight = temp->weight;
+            *tail = newVertex;
+            tail = &newVertex->next;
+
+            if (temp->vertexKey == parent[originalKeys[vertexIndex]])
+            {
+                relabeled->listOfAncestors[vertexIndex] = newVertex;
+            }
+        }
+    }
+
+    relabeled->edgesCount = graph->edgesCount;
+    relabeled->weighted = graph->weighted;
+    relabeled->root = newKeys[graph->root];
+    relabeled->originalKeys = originalKeys;
+
+    free(parent);
+    freeGraph(graphPtr);
+    *graphPtr = relabeled;
+
+    return newKeys;
+}
+
+/**
+ * @brief Reads the trees file of a server, one graph file or index file per line. An index file is mapped, a graph
+ * file is read and preprocessed. Prints an error message on failure
+ * @param file the path of the trees file
+ * @param server its trees are set to the trees of the file, also on failure
+ * */
+bool readTreesFile(char *file, QueryServer *server)
+{
+    FILE *fp;
+    char line[MAX_ROW_LENGTH + 1];
+    int capacity = SERVER_FIRST_TREES_CAPACITY;
+    Graph *graph;
+    TreeAnalysis *analysis;
+    TreeIndex *index;
+
+    server->trees = malloc(capacity * sizeof(TreeIndex *));
+    server->treesCount = 0;
+
+    fp = fopen(file, "r");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "%s", SERVE_USAGE_MSG);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        // remove line terminators
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0')
+        {
+            continue;
+        }
+
+        index = mapTreeIndex(line);
+        if (index == NULL)
+        {
+            if (!loadTree(line, &graph, &analysis))
+            {
+                fclose(fp);
+                return false;
+            }
+
+            // only the index is needed for answering the queries
+            index = buildTreeIndex(graph, analysis);
+            freeTreeAnalysis(&analysis);
+            freeGraph(&graph);
+        }
+
+        if (server->treesCount == capacity)
+        {
+            capacity *= 2;
+            server->trees = realloc(server->trees, capacity * sizeof(TreeIndex *));
+        }
+        server->trees[server->treesCount++] = index;
+    }
+
+    fclose(fp);
+
+    if (server->treesCount == 0)
+    {
+        fprintf(stderr, "%s", SERVE_USAGE_MSG);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Answers a single request to the server: "tree <k>" selects the k-th tree of the trees file, any other line
+ * is a query on the selected tree, as in a queries file
+ * @param session the connection the request was sent on
+ * @param line
+ * @param out the stream to print the answer to
+ * @return false when the line is not a valid request
+ * */
+bool executeServerRequest(ServerSession *session, char *line, FILE *out)
+{
+    char name[QUERY_NAME_LENGTH];
+    int nameLength = 0;
+    char *end;
+    long treeKey;
+    QueryEngine *engine;
+
+    if ((sscanf(line, "%31s%n", name, &nameLength) == 1) && (strcmp(name, SERVER_TREE_COMMAND) == 0))
+    {
+        treeKey = strtol(line + nameLength, &end, 10);
+        if ((end == line + nameLength) || (end[strspn(end, " ")] != '\0') || (treeKey < 0) ||
+            (treeKey >= session->server->treesCount))
+        {
+            return false;
+        }
+
+        session->current = (int) treeKey;
+        return true;
+    }
+
+    // the scratch memory of a tree is allocated only when it is queried
+    engine = &session->engines[session->current];
+    if (engine->index == NULL)
+    {
+        initQueryEngine(engine, session->server->trees[session->current]);
+    }
+
+    return executeQuery(engine, line, out);
+}
+
+/**
+ * @brief Answers the requests of a single connection, one request per line, until it is closed or the server is
+ * stopped. The answer of a valid request ends with SERVER_OK_MSG, an invalid request is answered by
+ * INVALID_QUERY_MSG and the connection stays open
+ * @param server
+ * @param in the stream of the requests
+ * @param out the stream of the answers
+ * */
+void serveSession(QueryServer *server, FILE *in, FILE *out)
+{
+    ServerSession session;
+    char line[MAX_ROW_LENGTH + 1];
+    char name[QUERY_NAME_LENGTH];
+    int i;
+
+    session.server = server;
+    session.engines = calloc(server->treesCount, sizeof(QueryEngine));
+    session.current = 0;
+
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        // remove line terminators
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if ((sscanf(line, "%31s", name) == 1) && (strcmp(name, SERVER_SHUTDOWN_COMMAND) == 0))
+        {
+            // answered first, stopping the server shuts this connection down as well
+            fprintf(out, "%s", SERVER_OK_MSG);
+            fflush(out);
+            stopServer(server);
+            break;
+        }
+
+        fprintf(out, "%s", executeServerRequest(&session, line, out) ? SERVER_OK_MSG : INVALID_QUERY_MSG);
+        fflush(out);
+    }
+
+    // the indexes are shared with the other connections
+    for (i = 0; i < server->treesCount; i++)
+    {
+        free(session.engines[i].scratch);
+        freePathDecomposition(&session.engines[i].paths);
+    }
+    free(session.engines);
+}
+
+/**
+ * @brief Stops a server: no more connections are accepted and the open connections are shut down, which ends the
+ * sessions of all the workers
+ * @param server
+ * */
+void stopServer(QueryServer *server)
+{
+    int clientFd;
+    int i;
+
+    __atomic_store_n(&server->stopped, true, __ATOMIC_SEQ_CST);
+    if (server->listenFd < 0)
+    {
+        return;
+    }
+
+    shutdown(server->listenFd, SHUT_RDWR);
+    for (i = 0; i < server->workersCount; i++)
+    {
+        clientFd = __atomic_load_n(&server->clientFds[i], __ATOMIC_SEQ_CST);
+        if (clientFd >= 0)
+        {
+            shutdown(clientFd, SHUT_RDWR);
+        }
+    }
+}
+
+/**
+ * @brief Accepts connections and serves them one after the other until the server is stopped. Every worker of the
+ * pool runs this task, so up to a connection per worker is served concurrently
+ * @param serverArgs the server
+ * @param threadIndex the index of the worker, its connection is published at clientFds[threadIndex]
+ * @param threadCount unused
+ * */
+void serveTask(void *serverArgs, int threadIndex, int threadCount)
+{
+    QueryServer *server = serverArgs;
+    FILE *in;
+    FILE *out;
+    int clientFd;
+
+    (void) threadCount;
+
+    while (!__atomic_load_n(&server->stopped, __ATOMIC_SEQ_CST))
+    {
+        clientFd = accept(server->listenFd, NULL, NULL);
+        if (clientFd < 0)
+        {
+            // the listening socket is shut down when the server is stopped
+            if ((errno == EINTR) || (errno == ECONNABORTED))
+            {
+                continue;
+            }
+            break;
+        }
+
+        // a connection published after the server was stopped is not served
+        __atomic_store_n(&server->clientFds[threadIndex], clientFd, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&server->stopped, __ATOMIC_SEQ_CST))
+        {
+            __atomic_store_n(&server->clientFds[threadIndex], -1, __ATOMIC_SEQ_CST);
+            close(clientFd);
+            break;
+        }
+
+        in = fdopen(clientFd, "r");
+        out = fdopen(dup(clientFd), "w");
+        serveSession(server, in, out);
+
+        __atomic_store_n(&server->clientFds[threadIndex], -1, __ATOMIC_SEQ_CST);
+        fclose(out);
+        fclose(in);
+    }
+}
+
+/**
+ * @brief Creates the listening Unix domain socket of a server. A socket left at the path by an earlier server is
+ * replaced, any other file at the path is kept and the socket is not created
+ * @param server its listenFd is set on success
+ * @param path the path of the socket
+ * */
+bool listenOnSocket(QueryServer *server, char *path)
+{
+    struct sockaddr_un address;
+    struct stat pathStat;
+
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    if ((stat(path, &pathStat) == 0) && S_ISSOCK(pathStat.st_mode))
+    {
+        unlink(path);
+    }
+
+    server->listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server->listenFd < 0)
+    {
+        return false;
+    }
+
+    if ((bind(server->listenFd, (struct sockaddr *) &address, sizeof(address)) != 0) ||
+        (listen(server->listenFd, SOMAXCONN) != 0))
+    {
+        close(server->listenFd);
+        server->listenFd = -1;
         return false;
     }
 
-    // read the first line and whenever an empty file was given:
-    if (fgets(line, sizeof(line), fp) == NULL)
+    return true;
+}
+
+/**
+ * @brief Loads the trees of a trees file once and answers queries on them until a shutdown request, so every query
+ * is answered from the preprocessed trees. The requests are read from a Unix domain socket, or from stdin when the
+ * socket path is SERVE_STDIO. Expects the arguments --serve <Socket Path | -> <Trees File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runServeMode(char *argv[])
+{
+    QueryServer server;
+    ThreadPool *pool;
+    char *socketPath = argv[MODE_FIRST_ARG_INDEX];
+    bool success = true;
+    int i;
+
+    memset(&server, 0, sizeof(server));
+    server.listenFd = -1;
+
+    if (!readTreesFile(argv[MODE_SECOND_ARG_INDEX], &server))
+    {
+        success = false;
+    }
+    else if (strcmp(socketPath, SERVE_STDIO) == 0)
+    {
+        serveSession(&server, stdin, stdout);
+    }
+    else if (!listenOnSocket(&server, socketPath))
+    {
+        fprintf(stderr, "%s", SERVER_SOCKET_FAILED_MSG);
+        success = false;
+    }
+    else
+    {
+        // a client which leaves before reading its answers must not stop the server
+        signal(SIGPIPE, SIG_IGN);
+
+        server.workersCount = getThreadCount();
+        server.clientFds = malloc(server.workersCount * sizeof(int));
+        for (i = 0; i < server.workersCount; i++)
+        {
+            server.clientFds[i] = -1;
+        }
+
+        pool = initThreadPool(server.workersCount);
+        runParallel(pool, serveTask, &server);
+        freeThreadPool(&pool);
+
+        close(server.listenFd);
+        unlink(socketPath);
+        free(server.clientFds);
+    }
+
+    for (i = 0; i < server.treesCount; i++)
+    {
+        freeTreeIndex(&server.trees[i]);
+    }
+    free(server.trees);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Allocates the buffers for finding canonical forms of trees
+ * @param capacity the amount of vertices the buffers can hold, including a virtual root
+ * */
+CanonicalWorkspace *initCanonicalWorkspace(int capacity)
+{
+    CanonicalWorkspace *workspace = malloc(sizeof(CanonicalWorkspace));
+    size_t size = (capacity + 2) * sizeof(int);
+    int i;
+
+    workspace->capacity = capacity;
+    workspace->order = malloc(size);
+    workspace->parent = malloc(size);
+    workspace->depth = malloc(size);
+    workspace->name = malloc(size);
+    workspace->childCount = malloc(size);
+    workspace->tupleStart = malloc(size);
+    workspace->tupleFill = malloc(size);
+    workspace->tuples = malloc(size);
+    workspace->counts = malloc(size);
+    workspace->pairPosition = malloc(size);
+    workspace->pairName = malloc(size);
+    workspace->sortedPosition = malloc(size);
+    workspace->sortedName = malloc(size);
+    workspace->positionStart = malloc(size);
+    workspace->byLength = malloc(size);
+    workspace->queue = malloc(size);
+    workspace->next = malloc(size);
+    workspace->bucketHead = malloc(size);
+    workspace->bucketTail = malloc(size);
+
+    // every bucket is emptied after it is collected, so they are only initialized once
+    for (i = 0; i < capacity + 2; i++)
+    {
+        workspace->bucketHead[i] = -1;
+    }
+
+    return workspace;
+}
+
+/**
+ * @brief Frees the buffers for finding canonical forms of trees
+ * @param workspacePtr
+ * */
+void freeCanonicalWorkspace(CanonicalWorkspace **workspacePtr)
+{
+    CanonicalWorkspace *workspace = *workspacePtr;
+
+    free(workspace->order);
+    free(workspace->parent);
+    free(workspace->depth);
+    free(workspace->name);
+    free(workspace->childCount);
+    free(workspace->tupleStart);
+    free(workspace->tupleFill);
+    free(workspace->tuples);
+    free(workspace->counts);
+    free(workspace->pairPosition);
+    free(workspace->pairName);
+    free(workspace->sortedPosition);
+    free(workspace->sortedName);
+    free(workspace->positionStart);
+    free(workspace->byLength);
+    free(workspace->queue);
+    free(workspace->next);
+    free(workspace->bucketHead);
+    free(workspace->bucketTail);
+    free(workspace);
+    *workspacePtr = NULL;
+}
+
+/**
+ * @brief Traverses a graph level after level from a set of roots
+ * @param graph
+ * @param roots the vertices of the first level
+ * @param rootsCount
+ * @param order set to the reached vertices, in the order they were reached
+ * @param parent set to the vertex every vertex was reached from, -1 for the roots
+ * @param depth set to the level of every vertex, -1 for the vertices which were not reached
+ * @return the amount of vertices reached
+ * */
+int findBfsLevels(Graph *graph, int *roots, int rootsCount, int *order, int *parent, int *depth)
+{
+    int head = 0;
+    int tail = 0;
+    int vertexKey;
+    int i;
+    Vertex *temp;
+
+    for (i = 0; i < graph->verticesCount; i++)
+    {
+        depth[i] = -1;
+    }
+
+    for (i = 0; i < rootsCount; i++)
+    {
+        depth[roots[i]] = 0;
+        parent[roots[i]] = -1;
+        order[tail++] = roots[i];
+    }
+
+    while (head < tail)
+    {
+        vertexKey = order[head++];
+        for (temp = graph->listOfAdjacent[vertexKey]; temp != NULL; temp = temp->next)
+        {
+            if (depth[temp->vertexKey] == -1)
+            {
+                depth[temp->vertexKey] = depth[vertexKey] + 1;
+                parent[temp->vertexKey] = vertexKey;
+                order[tail++] = temp->vertexKey;
+            }
+        }
+    }
+
+    return tail;
+}
+
+/**
+ * @brief Find the centers of a tree, the middle vertices of a longest path
+ * @param graph
+ * @param workspace the buffers used for the traversals
+ * @param centers set to the one or two centers
+ * @return the amount of centers, 0 when the graph is not connected
+ * */
+int findTreeCenters(Graph *graph, CanonicalWorkspace *workspace, int *centers)
+{
+    int verticesCount = graph->verticesCount;
+    int farthest = 0;
+    int diameter;
+    int i;
+
+    // the farthest vertex from any vertex is an end of a longest path
+    if (findBfsLevels(graph, &farthest, 1, workspace->order, workspace->parent, workspace->depth) != verticesCount)
+    {
+        return 0;
+    }
+    farthest = workspace->order[verticesCount - 1];
+
+    findBfsLevels(graph, &farthest, 1, workspace->order, workspace->parent, workspace->depth);
+    farthest = workspace->order[verticesCount - 1];
+    diameter = workspace->depth[farthest];
+
+    for (i = 0; i < diameter / 2; i++)
+    {
+        farthest = workspace->parent[farthest];
+    }
+
+    centers[0] = farthest;
+    if (diameter % 2 == 0)
+    {
+        return 1;
+    }
+
+    centers[1] = workspace->parent[farthest];
+    return 2;
+}
+
+/**
+ * @brief Appends a vertex to the end of the bucket of a name
+ * @param workspace
+ * @param vertexKey
+ * @param name
+ * */
+void appendToBucket(CanonicalWorkspace *workspace, int vertexKey, int name)
+{
+    workspace->next[vertexKey] = -1;
+    if (workspace->bucketHead[name] == -1)
+    {
+        workspace->bucketHead[name] = vertexKey;
+    }
+    else
+    {
+        workspace->next[workspace->bucketTail[name]] = vertexKey;
+    }
+    workspace->bucketTail[name] = vertexKey;
+}
+
+/**
+ * @brief Sorts the vertices of a level by their tuples lexicographically, in time linear in the total length of the
+ * tuples and in the amount of names (the lexicographic sort of Aho, Hopcroft and Ullman). The tuples are bucketed
+ * by every position from the last one, and only the names which appear at a position are collected in its pass
+ * @param workspace holding the tuples of the vertices
+ * @param vertices the vertices of the level, sorted in place
+ * @param count the amount of vertices
+ * @param namesCount the amount of names in the tuples
+ * */
+void sortLevelTuples(CanonicalWorkspace *workspace, int *vertices, int count, int namesCount)
+{
+    int *counts = workspace->counts;
+    int maxLength = 0;
+    int pairsCount = 0;
+    int distinctCount = 0;
+    int queueCount = 0;
+    int vertexKey, length, position, name, sum;
+    int i, j;
+
+    for (i = 0; i < count; i++)
+    {
+        if (workspace->childCount[vertices[i]] > maxLength)
+        {
+            maxLength = workspace->childCount[vertices[i]];
+        }
+    }
+
+    // a level of leaves is already sorted
+    if (maxLength == 0)
+    {
+        return;
+    }
+
+    // the (position, name) pairs of all the tuples, sorted by name
+    memset(counts, 0, namesCount * sizeof(int));
+    for (i = 0; i < count; i++)
+    {
+        vertexKey = vertices[i];
+        for (position = 0; position < workspace->childCount[vertexKey]; position++)
+        {
+            counts[workspace->tuples[workspace->tupleStart[vertexKey] + position]]++;
+        }
+    }
+    for (name = 0, sum = 0; name < namesCount; name++)
+    {
+        sum += counts[name];
+        counts[name] = sum - counts[name];
+    }
+    for (i = 0; i < count; i++)
+    {
+        vertexKey = vertices[i];
+        for (position = 0; position < workspace->childCount[vertexKey]; position++)
+        {
+            name = workspace->tuples[workspace->tupleStart[vertexKey] + position];
+            workspace->sortedPosition[counts[name]] = position;
+            workspace->sortedName[counts[name]++] = name;
+            pairsCount++;
+        }
+    }
+
+    // then stably by position, so the names of every position are in increasing order
+    memset(counts, 0, maxLength * sizeof(int));
+    for (i = 0; i < pairsCount; i++)
+    {
+        counts[workspace->sortedPosition[i]]++;
+    }
+    for (position = 0, sum = 0; position < maxLength; position++)
+    {
+        sum += counts[position];
+        counts[position] = sum - counts[position];
+    }
+    for (i = 0; i < pairsCount; i++)
+    {
+        j = counts[workspace->sortedPosition[i]]++;
+        workspace->pairPosition[j] = workspace->sortedPosition[i];
+        workspace->pairName[j] = workspace->sortedName[i];
+    }
+
+    // keep the distinct names of every position
+    for (i = 0; i < pairsCount; i++)
+    {
+        if ((distinctCount == 0) || (workspace->pairPosition[i] != workspace->pairPosition[distinctCount - 1]) ||
+            (workspace->pairName[i] != workspace->pairName[distinctCount - 1]))
+        {
+            workspace->pairPosition[distinctCount] = workspace->pairPosition[i];
+            workspace->pairName[distinctCount++] = workspace->pairName[i];
+        }
+    }
+    for (position = 0, j = 0; position <= maxLength; position++)
+    {
+        while ((j < distinctCount) && (workspace->pairPosition[j] < position))
+        {
+            j++;
+        }
+        workspace->positionStart[position] = j;
+    }
+
+    // the vertices by the lengths of their tuples, counts[length] is the first vertex of every length
+    memset(counts, 0, (maxLength + 2) * sizeof(int));
+    for (i = 0; i < count; i++)
+    {
+        counts[workspace->childCount[vertices[i]] + 1]++;
+    }
+    for (length = 1; length <= maxLength + 1; length++)
+    {
+        counts[length] += counts[length - 1];
+    }
+    memcpy(workspace->sortedPosition, counts, (maxLength + 1) * sizeof(int));
+    for (i = 0; i < count; i++)
+    {
+        workspace->byLength[workspace->sortedPosition[workspace->childCount[vertices[i]]]++] = vertices[i];
+    }
+
+    // sort by every position from the last one. The tuples ending at a position come before the longer ones
+    for (position = maxLength - 1; position >= 0; position--)
+    {
+        for (i = counts[position + 1]; i < counts[position + 2]; i++)
+        {
+            vertexKey = workspace->byLength[i];
+            appendToBucket(workspace, vertexKey, workspace->tuples[workspace->tupleStart[vertexKey] + position]);
+        }
+        for (i = 0; i < queueCount; i++)
+        {
+            vertexKey = workspace->queue[i];
+            appendToBucket(workspace, vertexKey, workspace->tuples[workspace->tupleStart[vertexKey] + position]);
+        }
+
+        queueCount = 0;
+        for (j = workspace->positionStart[position]; j < workspace->positionStart[position + 1]; j++)
+        {
+            name = workspace->pairName[j];
+            for (vertexKey = workspace->bucketHead[name]; vertexKey != -1; vertexKey = workspace->next[vertexKey])
+            {
+                workspace->queue[queueCount++] = vertexKey;
+            }
+            workspace->bucketHead[name] = -1;
+        }
+    }
+
+    // the leaves come first
+    memcpy(vertices, workspace->byLength, counts[1] * sizeof(int));
+    memcpy(vertices + counts[1], workspace->queue, queueCount * sizeof(int));
+}
+
+/**
+ * @brief Checks whenever two vertices have the same tuple
+ * @param workspace
+ * @param uVertexKey
+ * @param vVertexKey
+ * */
+bool isSameTuple(CanonicalWorkspace *workspace, int uVertexKey, int vVertexKey)
+{
+    return (workspace->childCount[uVertexKey] == workspace->childCount[vVertexKey]) &&
+           (memcmp(workspace->tuples + workspace->tupleStart[uVertexKey],
+                   workspace->tuples + workspace->tupleStart[vVertexKey],
+                   workspace->childCount[uVertexKey] * sizeof(int)) == 0);
+}
+
+/**
+ * @brief Find the canonical form of a tree in linear time (AHU). The levels are named from the deepest one up: the
+ * names of a level are written to the tuples of their parents in increasing order with a counting sort, the tuples
+ * of the level above are sorted with sortLevelTuples, and every vertex is named by the rank of its tuple. The
+ * encoding lists the sorted tuples of every level, so it is the same for two trees exactly when they are isomorphic
+ * @param graph
+ * @param rooted whenever the tree is rooted at its root, otherwise at its centers
+ * @param workspace buffers for at least one vertex more than the graph has
+ * @param canonical set to the canonical form. Its encoding is released by the caller
+ * @return false when the graph is not a tree
+ * */
+bool findCanonicalTree(Graph *graph, bool rooted, CanonicalWorkspace *workspace, CanonicalTree *canonical)
+{
+    int verticesCount = graph->verticesCount;
+    int *order = workspace->order;
+    int roots[MAX_CENTERS];
+    int rootsCount = 1;
+    int count = verticesCount;
+    int namesCount = 0;
+    int levelStart, levelEnd, childEnd, levelDepth;
+    int vertexKey, start, i;
+    int *encoding;
+    int length = 0;
+    uint64_t hash = CANONICAL_HASH_OFFSET;
+
+    if (graph->edgesCount != verticesCount - 1)
     {
-        fprintf(stderr, "%s", INVALID_USAGE_MSG);
-        fclose(fp);
         return false;
     }
 
-    // remove line terminators
-    sscanf(line, "%[^\r]", line);
-    sscanf(line, "%[^\n]", line);
+    if (rooted)
+    {
+        if (!setRootVertexKey(graph))
+        {
+            return false;
+        }
+        roots[0] = graph->root;
+    }
+    else
+    {
+        rootsCount = findTreeCenters(graph, workspace, roots);
+        if (rootsCount == 0)
+        {
+            return false;
+        }
+    }
 
-    // check whenever the first line displays the expected number of rows
-    if ((!validateVertexAmountLine(line)))
+    if (findBfsLevels(graph, roots, rootsCount, order, workspace->parent, workspace->depth) != verticesCount)
     {
-        fprintf(stderr, "%s", INVALID_INPUT_MSG);
-        fclose(fp);
         return false;
     }
 
-    // get the number of vertices the graph should have
-    *numOfVertices = (int) strtod(line, NULL);
+    // two centers hang from a virtual root, the vertex after the last one
+    if (rootsCount == MAX_CENTERS)
+    {
+        memmove(order + 1, order, verticesCount * sizeof(int));
+        order[0] = verticesCount;
+        for (i = 0; i < verticesCount; i++)
+        {
+            workspace->depth[i]++;
+        }
+        workspace->depth[verticesCount] = 0;
+        workspace->parent[verticesCount] = -1;
+        workspace->parent[roots[0]] = verticesCount;
+        workspace->parent[roots[1]] = verticesCount;
+        count++;
+    }
 
-    //
-    *vertexAdjContent = malloc((*numOfVertices) * (sizeof(char *)));
+    // the tuple of every vertex is a range of the tuples, in the order of the traversal
+    for (i = 0; i < count; i++)
+    {
+        workspace->childCount[i] = 0;
+        workspace->tupleFill[i] = 0;
+    }
+    for (i = 1; i < count; i++)
+    {
+        workspace->childCount[workspace->parent[order[i]]]++;
+    }
+    for (i = 0, start = 0; i < count; i++)
+    {
+        workspace->tupleStart[order[i]] = start;
+        start += workspace->childCount[order[i]];
+    }
 
+    // the size of every level, the length of every tuple and every name but the one of the root
+    encoding = malloc((workspace->depth[order[count - 1]] + 1 + 2 * count - 1) * sizeof(int));
 
-    // get the the list of adjacent vertices
-    while (fgets(line, sizeof(line), fp) != NULL)
+    levelEnd = count;
+    childEnd = count;
+    while (levelEnd > 0)
     {
+        levelDepth = workspace->depth[order[levelEnd - 1]];
+        for (levelStart = levelEnd - 1; (levelStart > 0) && (workspace->depth[order[levelStart - 1]] == levelDepth);
+             levelStart--)
+        {
+        }
 
-        // remove line terminators
-        sscanf(line, "%[^\r]", line);
-        sscanf(line, "%[^\n]", line);
+        // write the names of the level below to the tuples of their parents, in increasing order
+        if (levelEnd < count)
+        {
+            memset(workspace->counts, 0, namesCount * sizeof(int));
+            for (i = levelEnd; i < childEnd; i++)
+            {
+                workspace->counts[workspace->name[order[i]]]++;
+            }
+            for (i = 0, start = 0; i < namesCount; i++)
+            {
+                start += workspace->counts[i];
+                workspace->counts[i] = start - workspace->counts[i];
+            }
+            for (i = levelEnd; i < childEnd; i++)
+            {
+                workspace->queue[workspace->counts[workspace->name[order[i]]]++] = order[i];
+            }
+            for (i = 0; i < childEnd - levelEnd; i++)
+            {
+                vertexKey = workspace->parent[workspace->queue[i]];
+                workspace->tuples[workspace->tupleStart[vertexKey] + workspace->tupleFill[vertexKey]++] =
+                        workspace->name[workspace->queue[i]];
+            }
+        }
 
-        if (!validateVertexEdgeLine(line, rowIndex, *numOfVertices))
+        sortLevelTuples(workspace, order + levelStart, levelEnd - levelStart, namesCount);
+
+        // name the vertices by the ranks of their tuples, and append the level to the encoding
+        encoding[length++] = levelEnd - levelStart;
+        namesCount = 0;
+        for (i = levelStart; i < levelEnd; i++)
         {
+            vertexKey = order[i];
+            if ((i > levelStart) && (!isSameTuple(workspace, order[i - 1], vertexKey)))
+            {
+                namesCount++;
+            }
+            workspace->name[vertexKey] = namesCount;
 
-            fclose(fp);
-            return false;
+            encoding[length++] = workspace->childCount[vertexKey];
+            memcpy(encoding + length, workspace->tuples + workspace->tupleStart[vertexKey],
+                   workspace->childCount[vertexKey] * sizeof(int));
+            length += workspace->childCount[vertexKey];
         }
+        namesCount++;
 
-        // add the row
-        (*(vertexAdjContent))[rowIndex] = calloc(strlen(line) + 1, sizeof(char));
-        strcpy((*(vertexAdjContent))[rowIndex], line);
-        rowIndex++;
+        childEnd = levelEnd;
+        levelEnd = levelStart;
     }
 
-    // check the number of rows
-    if (rowIndex < *numOfVertices)
+    canonical->verticesCount = verticesCount;
+    canonical->centersCount = rooted ? 0 : rootsCount;
+    canonical->encoding = encoding;
+    canonical->encodingLength = length;
+
+    // FNV-1a over the words of the form
+    hash = (hash ^ (uint64_t) verticesCount) * CANONICAL_HASH_PRIME;
+    hash = (hash ^ (uint64_t) canonical->centersCount) * CANONICAL_HASH_PRIME;
+    for (i = 0; i < length; i++)
+    {
+        hash = (hash ^ (uint32_t) encoding[i]) * CANONICAL_HASH_PRIME;
+    }
+    canonical->hash = hash;
+
+    return true;
+}
+
+/**
+ * @brief Checks whenever two canonical forms are the same, so their trees are isomorphic
+ * @param first
+ * @param second
+ * */
+bool isSameCanonicalTree(CanonicalTree *first, CanonicalTree *second)
+{
+    return (first->hash == second->hash) && (first->verticesCount == second->verticesCount) &&
+           (first->centersCount == second->centersCount) && (first->encodingLength == second->encodingLength) &&
+           (memcmp(first->encoding, second->encoding, first->encodingLength * sizeof(int)) == 0);
+}
+
+/**
+ * @brief Compares jobs by the canonical forms of their trees, and jobs with the same form by their order in the
+ * manifest. Used for sorting pointers to the jobs
+ * @param first
+ * @param second
+ * */
+int compareCanonicalJobs(const void *first, const void *second)
+{
+    IsomorphismJob *firstJob = *(IsomorphismJob *const *) first;
+    IsomorphismJob *secondJob = *(IsomorphismJob *const *) second;
+    CanonicalTree *firstTree = &firstJob->canonical;
+    CanonicalTree *secondTree = &secondJob->canonical;
+    int difference;
+
+    if (firstTree->hash != secondTree->hash)
+    {
+        return (firstTree->hash < secondTree->hash) ? -1 : 1;
+    }
+    if (firstTree->verticesCount != secondTree->verticesCount)
+    {
+        return firstTree->verticesCount - secondTree->verticesCount;
+    }
+    if (firstTree->centersCount != secondTree->centersCount)
+    {
+        return firstTree->centersCount - secondTree->centersCount;
+    }
+    if (firstTree->encodingLength != secondTree->encodingLength)
+    {
+        return firstTree->encodingLength - secondTree->encodingLength;
+    }
+
+    difference = memcmp(firstTree->encoding, secondTree->encoding, firstTree->encodingLength * sizeof(int));
+    if (difference != 0)
+    {
+        return difference;
+    }
+
+    return (firstJob < secondJob) ? -1 : (firstJob > secondJob);
+}
+
+/**
+ * @brief Reads an isomorphism manifest, a graph file per line. Empty lines are skipped
+ * @param file the path of the manifest
+ * @param isomorphism its jobs are set to the graph files of the manifest
+ * @return false when the manifest can not be read
+ * */
+bool readIsomorphismManifest(char *file, Isomorphism *isomorphism)
+{
+    FILE *fp;
+    char line[MAX_ROW_LENGTH + 1];
+    int capacity = BATCH_FIRST_JOBS_CAPACITY;
+
+    fp = fopen(file, "r");
+    if (fp == NULL)
     {
-        fprintf(stderr, "%s", INVALID_INPUT_MSG);
-        fclose(fp);
         return false;
     }
 
+    isomorphism->jobs = malloc(capacity * sizeof(IsomorphismJob));
+    isomorphism->jobsCount = 0;
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        // remove line terminators
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0')
+        {
+            continue;
+        }
+
+        if (isomorphism->jobsCount == capacity)
+        {
+            capacity *= 2;
+            isomorphism->jobs = realloc(isomorphism->jobs, capacity * sizeof(IsomorphismJob));
+        }
+        memset(&isomorphism->jobs[isomorphism->jobsCount], 0, sizeof(IsomorphismJob));
+        isomorphism->jobs[isomorphism->jobsCount++].file = strdup(line);
+    }
+
     fclose(fp);
     return true;
-
 }
 
-
 /**
- * @brief Find some leaf in the graph
- * @param graph
+ * @brief Finds the canonical form of the tree of a single job, or the error message the default analysis would
+ * print for its graph file
+ * @param job
+ * @param rooted whenever the tree is rooted at its root, otherwise at its centers
+ * @param workspacePtr the buffers of the thread running the job, replaced when they are too small
  * */
-int findLeafIndex(Graph *graph)
+void runIsomorphismJob(IsomorphismJob *job, bool rooted, CanonicalWorkspace **workspacePtr)
 {
-    int length = graph->verticesCount;
-    int i = 0;
-    int leafIndex = 0;
+    char *errorMsg = NULL;
+    size_t errorSize = 0;
+    FILE *errorOut = open_memstream(&errorMsg, &errorSize);
+    Graph *graph;
 
-    for (i = 0; i < length; i++)
+    if (readGraph(job->file, 0, &graph, NULL, errorOut))
     {
-        leafIndex = i;
-        if (graph->listOfAdjacent[i] == NULL)
+        // the buffers of the previous job are reused when they are large enough, a virtual root may be added
+        if ((*workspacePtr != NULL) && ((*workspacePtr)->capacity < graph->verticesCount + 1))
         {
-            continue;
+            freeCanonicalWorkspace(workspacePtr);
         }
-
-        // check whenever the vertex is a leaf
-        if (graph->listOfAdjacent[i]->next == NULL)
+        if (*workspacePtr == NULL)
         {
-            break;
+            *workspacePtr = initCanonicalWorkspace(graph->verticesCount + 1);
         }
 
+        if (!findCanonicalTree(graph, rooted, *workspacePtr, &job->canonical))
+        {
+            fprintf(errorOut, "%s", GRAPH_NOT_TREE_MSG);
+        }
+        freeGraph(&graph);
     }
-    return leafIndex;
 
+    fclose(errorOut);
+    if (errorSize > 0)
+    {
+        job->error = errorMsg;
+    }
+    else
+    {
+        free(errorMsg);
+    }
 }
 
-
 /**
- * @brief Find out the root of the graph
- * @param graph
- * @param vertexKey
+ * @brief Runs the jobs of an isomorphism manifest on a thread, until no job is left
+ * @param isomorphismArgs the isomorphism manifest
+ * @param threadIndex
+ * @param threadCount
  * */
-void setRootVertexKey(Graph *graph)
+void isomorphismTask(void *isomorphismArgs, int threadIndex, int threadCount)
 {
-    int leafIndex = findLeafIndex(graph);
-    int rootIndex = leafIndex;
-    Vertex *currentVertex;
+    Isomorphism *isomorphism = isomorphismArgs;
+    int jobIndex;
 
-    while (graph->listOfAncestors[rootIndex] != NULL)
+    (void) threadCount;
+
+    jobIndex = __atomic_fetch_add(&isomorphism->nextJob, 1, __ATOMIC_RELAXED);
+    while (jobIndex < isomorphism->jobsCount)
     {
-        currentVertex = graph->listOfAncestors[rootIndex];
-        rootIndex = currentVertex->vertexKey;
+        runIsomorphismJob(&isomorphism->jobs[jobIndex], isomorphism->rooted, &isomorphism->workspaces[threadIndex]);
+        jobIndex = __atomic_fetch_add(&isomorphism->nextJob, 1, __ATOMIC_RELAXED);
     }
-    graph->root = rootIndex;
 }
 
 /**
- * @brief Get the degree of a given vertex in a graph
- * @param graph
- * @param vertexKey
+ * @brief Prints the isomorphism classes as json lines, every class at the place of its first file in the manifest.
+ * A file which failed is printed with its error message at its own place
+ * @param isomorphism
+ * @param sorted the jobs which succeeded, sorted by compareCanonicalJobs
+ * @param sortedCount
  * */
-int getVertexDeg(Graph *graph, int vertexKey)
+void printIsomorphismClasses(Isomorphism *isomorphism, IsomorphismJob **sorted, int sortedCount)
 {
+    IsomorphismJob *job;
+    int classesCount = 0;
+    int i, j;
 
-    Vertex *vertexPtr = graph->listOfAdjacent[vertexKey];
-    int deg = 0;
+    for (i = 0; i < sortedCount; i++)
+    {
+        sorted[i]->classStart = ((i > 0) && isSameCanonicalTree(&sorted[i - 1]->canonical, &sorted[i]->canonical)) ?
+                                sorted[i - 1]->classStart : i;
+    }
 
-    while (vertexPtr)
+    for (i = 0; i < isomorphism->jobsCount; i++)
     {
-        deg++;
+        job = &isomorphism->jobs[i];
+        if (job->error != NULL)
+        {
+            printf("{\"file\": ");
+            printJsonString(stdout, job->file, strlen(job->file));
+            printf(", \"error\": ");
+            printJsonString(stdout, job->error, strcspn(job->error, "\n"));
+            printf("}\n");
+            continue;
+        }
 
-        vertexPtr = vertexPtr->next;
+        // the first file of a class prints the whole class
+        if (sorted[job->classStart] != job)
+        {
+            continue;
+        }
+
+        printf("{\"class\": %d, \"hash\": \"%016llx\", \"vertices\": %d, \"files\": [", classesCount++,
+               (unsigned long long) job->canonical.hash, job->canonical.verticesCount);
+        for (j = job->classStart; (j < sortedCount) && (sorted[j]->classStart == job->classStart); j++)
+        {
+            printf("%s", (j == job->classStart) ? "" : ", ");
+            printJsonString(stdout, sorted[j]->file, strlen(sorted[j]->file));
+        }
+        printf("]}\n");
     }
-    return deg;
 }
 
 /**
- * @brief Add edges to the graph
- * @param graph
- * @param contentToAttach an array of string in the format of the txt input
+ * @brief Groups the trees of the graph files of a manifest by their isomorphism classes. The canonical forms are
+ * found in parallel, then the jobs are sorted by them so every class is a run of the sorted jobs
+ * @param manifest the path of the manifest
+ * @param rooted whenever the trees are compared as rooted at their roots, otherwise at their centers
+ * @return the exit code of the program, a failure when any of the files is not a valid tree
  * */
-void attachEdges(Graph *graph, char **contentToAttach)
+int groupIsomorphicTrees(char *manifest, bool rooted)
 {
+    Isomorphism isomorphism;
+    IsomorphismJob **sorted;
+    ThreadPool *pool;
+    int sortedCount = 0;
+    int threadCount;
+    int i;
 
-    int u;
-    long int v;
-
-    int verticesCount = graph->verticesCount;
-    char *nextNumber;
+    if (!readIsomorphismManifest(manifest, &isomorphism))
+    {
+        fprintf(stderr, "%s", rooted ? ROOTED_ISOMORPHISM_USAGE_MSG : ISOMORPHISM_USAGE_MSG);
+        return EXIT_FAILURE;
+    }
 
-    // attach the edges
-    for (u = 0; u < verticesCount; u++)
+    // a thread without a job would only hold idle buffers
+    threadCount = getThreadCount();
+    if (threadCount > isomorphism.jobsCount)
     {
-        nextNumber = contentToAttach[u];
+        threadCount = (isomorphism.jobsCount > 0) ? isomorphism.jobsCount : 1;
+    }
+
+    isomorphism.nextJob = 0;
+    isomorphism.rooted = rooted;
+    isomorphism.workspaces = calloc(threadCount, sizeof(CanonicalWorkspace *));
+    pool = initThreadPool(threadCount);
+    runParallel(pool, isomorphismTask, &isomorphism);
+    freeThreadPool(&pool);
 
-        // check leaf
-        if (strcmp(IS_LEAF, nextNumber) == 0)
+    sorted = malloc((isomorphism.jobsCount + 1) * sizeof(IsomorphismJob *));
+    for (i = 0; i < isomorphism.jobsCount; i++)
+    {
+        if (isomorphism.jobs[i].error == NULL)
         {
-            continue;
+            sorted[sortedCount++] = &isomorphism.jobs[i];
         }
+    }
+    qsort(sorted, sortedCount, sizeof(IsomorphismJob *), compareCanonicalJobs);
+
+    printIsomorphismClasses(&isomorphism, sorted, sortedCount);
 
-        // iterate over each index of vertice and add it
-        while (*nextNumber)
+    for (i = 0; i < isomorphism.jobsCount; i++)
+    {
+        free(isomorphism.jobs[i].file);
+        free(isomorphism.jobs[i].error);
+        free(isomorphism.jobs[i].canonical.encoding);
+    }
+    for (i = 0; i < threadCount; i++)
+    {
+        if (isomorphism.workspaces[i] != NULL)
         {
-            v = strtol(nextNumber, &nextNumber, 10);
-            addEdge(graph, u, v);
+            freeCanonicalWorkspace(&isomorphism.workspaces[i]);
+        }
+    }
+    free(isomorphism.workspaces);
+    free(isomorphism.jobs);
+    free(sorted);
 
-            // no more numbers
-            if (strlen(nextNumber) == 0)
-            {
-                break;
-            }
+    return (sortedCount == isomorphism.jobsCount) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-            nextNumber++;
-        }
+/**
+ * @brief Groups the graph files of a manifest by the isomorphism classes of their trees, compared as unrooted trees.
+ * Expects the arguments --isomorphism <Manifest File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runIsomorphismMode(char *argv[])
+{
+    return groupIsomorphicTrees(argv[MODE_FIRST_ARG_INDEX], false);
+}
+
+/**
+ * @brief Groups the graph files of a manifest by the isomorphism classes of their trees, compared as rooted at
+ * their roots. Expects the arguments --rooted-isomorphism <Manifest File Path>
+ * @param argv
+ * @return the exit code of the program
+ * */
+int runRootedIsomorphismMode(char *argv[])
+{
+    return groupIsomorphicTrees(argv[MODE_FIRST_ARG_INDEX], true);
+}
+
+/**
+ * @brief Reads a graph file without requiring it to be a tree. The binary and prufer formats only hold trees, so
+ * they are read as trees. Prints an error message on failure
+ * @param file the path of the graph file
+ * @param maxVertexKey the largest vertex the caller asks about. Input with less vertices is invalid
+ * @param graphPtr set to the built graph on success
+ * */
+bool readGeneralGraph(char *file, int maxVertexKey, Graph **graphPtr)
+{
+    GraphRows rows;
+
+    if (isBinaryGraphFile(file) || isPruferFile(file))
+    {
+        return readGraph(file, maxVertexKey, graphPtr, NULL, stderr);
+    }
 
+    if (!parseGraphFile(&rows, file, maxVertexKey, false, stderr))
+    {
+        freeGraphRows(&rows);
+        return false;
     }
 
+    *graphPtr = initGraph(rows.verticesCount);
+    attachEdges(*graphPtr, &rows);
+    freeGraphRows(&rows);
+    return true;
 }
 
 /**
- * @brief Add edge between 2 vertices in a given graph
+ * @brief Copies a graph into contiguous arrays and finds its components
  * @param graph
- * @param uVertexIndex
- * @param vVertexIndex
  * */
-void addEdge(Graph *graph, int uVertexIndex, int vVertexIndex)
+GeneralGraph *initGeneralGraph(Graph *graph)
 {
+    GeneralGraph *general = malloc(sizeof(GeneralGraph));
+    int verticesCount = graph->verticesCount;
+    int vertexKey;
+
+    general->verticesCount = verticesCount;
+    general->edgesCount = graph->edgesCount;
+    general->adjacencyOffsets = malloc((verticesCount + 1) * sizeof(int));
+    general->adjacency = malloc(2 * (size_t) graph->edgesCount * sizeof(int) + 1);
+    buildAdjacencyArrays(graph, general->adjacencyOffsets, general->adjacency);
+
+    general->componentStarts = malloc(verticesCount * sizeof(int));
+    general->dist = malloc(verticesCount * sizeof(int));
+    general->parent = malloc(verticesCount * sizeof(int));
+    general->order = malloc(verticesCount * sizeof(int));
+    general->rootOrder = malloc(verticesCount * sizeof(int));
+    general->rootDist = malloc(verticesCount * sizeof(int));
+
+    // a vertex no traversal reached yet starts a new component. The rest of the distances stay from the traversals
+    general->componentsCount = 0;
+    general->orderCount = 0;
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        general->dist[vertexKey] = -1;
+    }
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        if (general->dist[vertexKey] == -1)
+        {
+            general->componentStarts[general->componentsCount++] = vertexKey;
+            findGeneralBfs(general, vertexKey);
+            general->orderCount = 0;
+        }
+    }
+    for (vertexKey = 0; vertexKey < verticesCount; vertexKey++)
+    {
+        general->dist[vertexKey] = -1;
+    }
 
-    // add the edge from u to v
-    Vertex *newVertex = createVertex(vVertexIndex);
-    newVertex->next = graph->listOfAdjacent[uVertexIndex];
-    graph->listOfAdjacent[uVertexIndex] = newVertex;
+    return general;
+}
 
-    // add the edge from v to u
-    newVertex = createVertex(uVertexIndex);
-    newVertex->next = graph->listOfAdjacent[vVertexIndex];
-    graph->listOfAdjacent[vVertexIndex] = newVertex;
+/**
+ * @brief Frees a general graph and its buffers
+ * @param graphPtr
+ * */
+void freeGeneralGraph(GeneralGraph **graphPtr)
+{
+    GeneralGraph *graph = *graphPtr;
+
+    free(graph->adjacencyOffsets);
+    free(graph->adjacency);
+    free(graph->componentStarts);
+    free(graph->dist);
+    free(graph->parent);
+    free(graph->order);
+    free(graph->rootOrder);
+    free(graph->rootDist);
+    free(graph);
+    *graphPtr = NULL;
+}
 
-    // save  the ancestors
-    graph->listOfAncestors[vVertexIndex] = newVertex;
+/**
+ * @brief Allocates the buffers of a bit parallel bfs, with no vertex reached
+ * @param verticesCount
+ * */
+BitParallelBfs *initBitParallelBfs(int verticesCount)
+{
+    BitParallelBfs *traversal = malloc(sizeof(BitParallelBfs));
 
-    // increase the edge count
-    graph->edgesCount = graph->edgesCount + 1;
+    traversal->seen = calloc(verticesCount, sizeof(uint64_t));
+    traversal->frontier = calloc(verticesCount, sizeof(uint64_t));
+    traversal->next = calloc(verticesCount, sizeof(uint64_t));
+    traversal->active = malloc(verticesCount * sizeof(int));
+    traversal->nextActive = malloc(verticesCount * sizeof(int));
+    traversal->touched = malloc(verticesCount * sizeof(int));
+    traversal->touchedCount = 0;
 
-};
+    return traversal;
+}
 
+/**
+ * @brief Frees the buffers of a bit parallel bfs
+ * @param traversalPtr
+ * */
+void freeBitParallelBfs(BitParallelBfs **traversalPtr)
+{
+    BitParallelBfs *traversal = *traversalPtr;
+
+    free(traversal->seen);
+    free(traversal->frontier);
+    free(traversal->next);
+    free(traversal->active);
+    free(traversal->nextActive);
+    free(traversal->touched);
+    free(traversal);
+    *traversalPtr = NULL;
+}
 
 /**
- * @brief Find out whenver a graph is a tree
+ * @brief Traverses the component of a vertex by bfs. Only the distances of the previous traversal are cleared,
+ * so a traversal of a small component does not touch the rest of the graph
  * @param graph
+ * @param startVertexKey
+ * @return the vertex reached last, one of the farthest from the start vertex
  * */
-bool isTree(Graph *graph)
+int findGeneralBfs(GeneralGraph *graph, int startVertexKey)
 {
+    int head = 0;
+    int vertexKey, neighbor, edge, i;
+
+    for (i = 0; i < graph->orderCount; i++)
+    {
+        graph->dist[graph->order[i]] = -1;
+    }
+
+    graph->dist[startVertexKey] = 0;
+    graph->parent[startVertexKey] = -1;
+    graph->order[0] = startVertexKey;
+    graph->orderCount = 1;
 
-    return ((isConnected(graph)) && (!graph->hasCycle));
+    while (head < graph->orderCount)
+    {
+        vertexKey = graph->order[head++];
+        for (edge = graph->adjacencyOffsets[vertexKey]; edge < graph->adjacencyOffsets[vertexKey + 1]; edge++)
+        {
+            neighbor = graph->adjacency[edge];
+            if (graph->dist[neighbor] == -1)
+            {
+                graph->dist[neighbor] = graph->dist[vertexKey] + 1;
+                graph->parent[neighbor] = vertexKey;
+                graph->order[graph->orderCount++] = neighbor;
+            }
+        }
+    }
+
+    return graph->order[graph->orderCount - 1];
 }
 
 /**
- * @brief Find out whenver a graph is connected
+ * @brief Find the eccentricities of up to BIT_PARALLEL_SOURCES vertices with a single bit parallel bfs. Every level
+ * passes the frontier words of the active vertices to their neighbors, and the sources whose bits reached a new
+ * vertex in a level have at least the distance of the level. A vertex is active while any source reaches it for
+ * the first time, so the edges of the graph are passed over once for every distinct distance of a vertex from the
+ * sources, instead of once for every source
  * @param graph
+ * @param traversal the buffers of the traversal
+ * @param sources the vertices to find the eccentricities of
+ * @param sourcesCount at most BIT_PARALLEL_SOURCES
+ * @param eccentricity filled with the eccentricity of every source, within its component
  * */
-bool isConnected(Graph *graph)
+void findBatchEccentricities(GeneralGraph *graph, BitParallelBfs *traversal, int *sources, int sourcesCount,
+                             int *eccentricity)
 {
-    DistanceFromNode distArray = calloc(graph->verticesCount, sizeof(int));
-    int i;
-    bool isConnected = true;
-
-    // fill the distance array
-    bfs(graph, graph->verticesCount - 1, distArray);
+    int activeCount = 0;
+    int nextActiveCount;
+    int level = 0;
+    int vertexKey, neighbor, edge, i;
+    uint64_t frontier, added, reached;
+    int *temp;
+
+    // clear the vertices of the previous traversal
+    for (i = 0; i < traversal->touchedCount; i++)
+    {
+        traversal->seen[traversal->touched[i]] = 0;
+    }
+    traversal->touchedCount = 0;
 
-    // count how whenever there is more then 1 connected component
-    for (i = 0; i < graph->verticesCount; i++)
+    for (i = 0; i < sourcesCount; i++)
     {
-        if (!graph->visited[i])
+        vertexKey = sources[i];
+        if (traversal->seen[vertexKey] == 0)
         {
-            isConnected = false;
+            traversal->touched[traversal->touchedCount++] = vertexKey;
+            traversal->active[activeCount++] = vertexKey;
         }
+        traversal->seen[vertexKey] |= (uint64_t) 1 << i;
+        traversal->frontier[vertexKey] = traversal->seen[vertexKey];
+        eccentricity[i] = 0;
     }
 
-    // delete the distance array
-    free(distArray);
-    return isConnected;
+    while (activeCount > 0)
+    {
+        level++;
+        nextActiveCount = 0;
+        for (i = 0; i < activeCount; i++)
+        {
+            vertexKey = traversal->active[i];
+            frontier = traversal->frontier[vertexKey];
+            for (edge = graph->adjacencyOffsets[vertexKey]; edge < graph->adjacencyOffsets[vertexKey + 1]; edge++)
+            {
+                neighbor = graph->adjacency[edge];
+                added = frontier & ~traversal->seen[neighbor];
+                if (added != 0)
+                {
+                    if (traversal->next[neighbor] == 0)
+                    {
+                        traversal->nextActive[nextActiveCount++] = neighbor;
+                    }
+                    traversal->next[neighbor] |= added;
+                }
+            }
+            traversal->frontier[vertexKey] = 0;
+        }
+
+        // the next level becomes the frontier
+        reached = 0;
+        for (i = 0; i < nextActiveCount; i++)
+        {
+            vertexKey = traversal->nextActive[i];
+            if (traversal->seen[vertexKey] == 0)
+            {
+                traversal->touched[traversal->touchedCount++] = vertexKey;
+            }
+            traversal->seen[vertexKey] |= traversal->next[vertexKey];
+            traversal->frontier[vertexKey] = traversal->next[vertexKey];
+            reached |= traversal->next[vertexKey];
+            traversal->next[vertexKey] = 0;
+        }
+        while (reached != 0)
+        {
+            eccentricity[__builtin_ctzll(reached)] = level;
+            reached &= reached - 1;
+        }
+
+        temp = traversal->active;
+        traversal->active = traversal->nextActive;
+        traversal->nextActive = temp;
+        activeCount = nextActiveCount;
+    }
 }
 
-void bfs(Graph *graph, int startVertexKey, DistanceFromNode distFromVertex)
+/**
+ * @brief Find the diameter of the component of a vertex exactly, with iFUB. A 2-sweep gives a lower bound and a
+ * center candidate, the middle of the path it found. Every vertex at distance i from the center has an
+ * eccentricity of at most 2i, so the levels of a bfs from the center are checked from the deepest one up, until the
+ * lower bound reaches twice the next level. The eccentricities of a level are found in bit parallel batches
+ * @param graph
+ * @param traversal the buffers of the bit parallel traversals
+ * @param startVertexKey a vertex of the component
+ * */
+int findComponentDiameter(GeneralGraph *graph, BitParallelBfs *traversal, int startVertexKey)
 {
-    Queue *q = allocQueue();
-    int adjVertex;
-    int dist = 0;
-    distFromVertex[startVertexKey] = dist;
-    enqueue(q, startVertexKey);
-    int i;
-    int currentVertex;
-    Vertex *temp;
-    int *traverseSource = malloc((graph->verticesCount) * sizeof(int));
-    //
-    for (i = 0; i < graph->verticesCount; i++)
+    int sources[BIT_PARALLEL_SOURCES];
+    int eccentricity[BIT_PARALLEL_SOURCES];
+    int lowerBound, center, level, rootCount, end, sourcesCount, i, j;
+
+    // the 2-sweep, the farthest vertex from any vertex is a good start for a long path
+    center = findGeneralBfs(graph, findGeneralBfs(graph, startVertexKey));
+    lowerBound = graph->dist[center];
+    for (i = 0; i < lowerBound / 2; i++)
     {
-        graph->visited[i] = 0;
-        traverseSource[i] = -1;
+        center = graph->parent[center];
     }
 
-    graph->visited[startVertexKey] = 1;
+    // the levels of the center are kept, the eccentricities of their vertices are found by other traversals
+    findGeneralBfs(graph, center);
+    rootCount = graph->orderCount;
+    for (i = 0; i < rootCount; i++)
+    {
+        graph->rootOrder[i] = graph->order[i];
+        graph->rootDist[i] = graph->dist[graph->order[i]];
+    }
 
+    level = graph->rootDist[rootCount - 1];
+    if (level > lowerBound)
+    {
+        lowerBound = level;
+    }
 
-    while (!queueIsEmpty(q))
+    end = rootCount;
+    while (2 * level > lowerBound)
     {
-        currentVertex = (int) dequeue(q);
-        temp = graph->listOfAdjacent[currentVertex];
-        while (temp)
+        /* the vertices of the level are the last ones left in the order of the center. A pair with a vertex left in
+         * the level is at most twice the level apart, so the level is left once the lower bound reaches that*/
+        for (i = end; (i > 0) && (graph->rootDist[i - 1] == level) && (2 * level > lowerBound); i -= sourcesCount)
         {
-            adjVertex = temp->vertexKey;
-
-            if (graph->visited[adjVertex] == 0)
+            sourcesCount = 0;
+            for (j = i - 1; (j >= 0) && (graph->rootDist[j] == level) && (sourcesCount < BIT_PARALLEL_SOURCES); j--)
             {
-                graph->visited[adjVertex] = 1;
-                distFromVertex[adjVertex] = distFromVertex[currentVertex] + 1;
-                enqueue(q, adjVertex);
-                traverseSource[adjVertex] = currentVertex;
+                sources[sourcesCount++] = graph->rootOrder[j];
             }
-                // cycle check
-            else if ((graph->visited[adjVertex] == 1) &&
-                     (traverseSource[currentVertex] != adjVertex))
+
+            findBatchEccentricities(graph, traversal, sources, sourcesCount, eccentricity);
+            for (j = 0; j < sourcesCount; j++)
             {
-                graph->hasCycle = true;
+                if (eccentricity[j] > lowerBound)
+                {
+                    lowerBound = eccentricity[j];
+                }
             }
-
-            temp = temp->next;
         }
-        dist++;
+
+        // a pair of vertices above the level is at most twice the next level apart
+        end = i;
+        level--;
     }
 
-    freeQueue(&q);
-    free(traverseSource);
+    return lowerBound;
 }
 
 /**
- * @brief Initialize a Graph  struct with a given size
- * @param verticesCount
+ * @brief Find the diameter of a general graph, the largest distance between two vertices of the same component
+ * @param graph
  * */
-Graph *initGraph(int verticesCount)
+int findGeneralDiameter(GeneralGraph *graph)
 {
-
-    Graph *graph = malloc(sizeof(Graph));
+    BitParallelBfs *traversal = initBitParallelBfs(graph->verticesCount);
+    int diameter = 0;
+    int componentDiameter;
     int i;
 
-    graph->verticesCount = verticesCount;
-    graph->listOfAdjacent = malloc(verticesCount * sizeof(Vertex *));
-    graph->listOfAncestors = malloc(verticesCount * sizeof(Vertex *));
-    graph->visited = malloc(verticesCount * sizeof(int *));
-    graph->edgesCount = 0;
-    graph->root = 0;
-    graph->hasCycle = false;
+    for (i = 0; i < graph->componentsCount; i++)
+    {
+        componentDiameter = findComponentDiameter(graph, traversal, graph->componentStarts[i]);
+        if (componentDiameter > diameter)
+        {
+            diameter = componentDiameter;
+        }
+    }
 
+    freeBitParallelBfs(&traversal);
+    return diameter;
+}
 
-    for (i = 0; i < verticesCount; i++)
+/**
+ * @brief Prints a shortest path between two vertices of a general graph, in the format of printShortestPath
+ * @param graph
+ * @param uVertexKey  the path start vertex
+ * @param vVertexKey the  path end vertex
+ * */
+void printGeneralPath(GeneralGraph *graph, int uVertexKey, int vVertexKey)
+{
+    int pathLength = 0;
+    int currentVertexKey;
+
+    printf("Shortest Path Between %d and %d:", uVertexKey, vVertexKey);
+
+    findGeneralBfs(graph, uVertexKey);
+    if (graph->dist[vVertexKey] == -1)
     {
-        graph->listOfAdjacent[i] = NULL;
-        graph->listOfAncestors[i] = NULL;
-        graph->visited[i] = 0;
+        printf("%s\n", NO_PATH_MSG);
+        return;
     }
 
-    return graph;
+    // climb from v to u, and print it backwards
+    for (currentVertexKey = vVertexKey; currentVertexKey != -1; currentVertexKey = graph->parent[currentVertexKey])
+    {
+        graph->rootOrder[pathLength++] = currentVertexKey;
+    }
+    while (pathLength > 0)
+    {
+        printf(" %d", graph->rootOrder[--pathLength]);
+    }
+
+    printf("\n");
 }
 
 /**
- * @brief Initialize a vertex struct with a given key value
- * @param vertexKey
+ * @brief Analyzes a general graph, which may have cycles and several components. A tree is analyzed as by the
+ * default analysis. Otherwise the amounts of vertices, edges and components, the exact diameter and a shortest path
+ * between the given vertices are printed. Expects the arguments --graph <Graph File Path> <First Vertex>
+ * <Second Vertex>
+ * @param argv
+ * @return the exit code of the program
  * */
-Vertex *createVertex(int vertexKey)
+int runGraphMode(char *argv[])
 {
+    Graph *graph;
+    TreeAnalysis *analysis;
+    GeneralGraph *general;
+    int firstVertex, secondVertex;
+
+    if ((nonNumerical(argv[MODE_SECOND_ARG_INDEX]) != 0) || (nonNumerical(argv[MODE_SECOND_ARG_INDEX + 1]) != 0))
+    {
+        fprintf(stderr, "%s", INVALID_INPUT_MSG);
+        return EXIT_FAILURE;
+    }
+    firstVertex = (int) strtod(argv[MODE_SECOND_ARG_INDEX], NULL);
+    secondVertex = (int) strtod(argv[MODE_SECOND_ARG_INDEX + 1], NULL);
+
+    if (!readGeneralGraph(argv[MODE_FIRST_ARG_INDEX], (firstVertex > secondVertex) ? firstVertex : secondVertex,
+                          &graph))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // a tree keeps the metrics of the default analysis
+    analysis = initTreeAnalysis(graph->verticesCount);
+    if (isTree(graph, analysis))
+    {
+        printTreeInfo(graph, analysis, firstVertex, secondVertex);
+        freeTreeAnalysis(&analysis);
+        freeGraph(&graph);
+        return EXIT_SUCCESS;
+    }
+    freeTreeAnalysis(&analysis);
+
+    if (graph->weighted)
+    {
+        fprintf(stderr, "%s", WEIGHTED_GRAPH_MSG);
+        freeGraph(&graph);
+        return EXIT_FAILURE;
+    }
 
-    Vertex *newVertex = malloc(sizeof(Vertex));
-    newVertex->vertexKey = vertexKey;
-    newVertex->next = NULL;
+    general = initGeneralGraph(graph);
+    freeGraph(&graph);
 
-    return newVertex;
-};
+    printf("%s%d\n", VERTICES_COUNT_MSG, general->verticesCount);
+    printf("%s%d\n", EDGES_COUNT_MSG, general->edgesCount);
+    printf("%s%d\n", COMPONENTS_COUNT_MSG, general->componentsCount);
+    printf("%s%d\n", DIAMETER_LENGTH_MSG, findGeneralDiameter(general));
+    printGeneralPath(general, firstVertex, secondVertex);
 
+    freeGeneralGraph(&general);
+    return EXIT_SUCCESS;
+}
 
 /**
- * @brief Finds the diameter of a given graph
- * @param graph
- * @param rootVertex the index of the root of the graph
+ * @brief Finds the eccentricities of batches of vertices on a thread, until no batch is left
+ * @param eccentricitiesArgs the eccentricities of the graph
+ * @param threadIndex
+ * @param threadCount
  * */
-int findGraphDiameter(Graph *graph, int rootVertex)
+void eccentricitiesTask(void *eccentricitiesArgs, int threadIndex, int threadCount)
 {
-    int farthestNodeFromRoot = rootVertex;
-    DistanceFromNode distFromNode = calloc(graph->verticesCount, sizeof(int));
-
-    int diameter = 0;
-    int vertexIndex;
-    int maxDistance = 0;
+    Eccentricities *eccentricities = eccentricitiesArgs;
+    GeneralGraph *graph = eccentricities->graph;
+    int eccentricity[BIT_PARALLEL_SOURCES];
+    int *sources;
+    int batchIndex, sourcesCount, i;
 
-    // performs bfs to get the distances from the root
-    bfs(graph, rootVertex, distFromNode);
+    (void) threadCount;
 
-    // find leaft with a maximal length from root
-    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    batchIndex = __atomic_fetch_add(&eccentricities->nextBatch, 1, __ATOMIC_RELAXED);
+    while (batchIndex < eccentricities->batchesCount)
     {
-
-        if (distFromNode[vertexIndex] > maxDistance)
+        sources = eccentricities->sources + batchIndex * BIT_PARALLEL_SOURCES;
+        sourcesCount = graph->verticesCount - batchIndex * BIT_PARALLEL_SOURCES;
+        if (sourcesCount > BIT_PARALLEL_SOURCES)
         {
-            maxDistance = distFromNode[vertexIndex];
-            farthestNodeFromRoot = vertexIndex;
+            sourcesCount = BIT_PARALLEL_SOURCES;
         }
-    }
 
-    // performs bfs to get the distances from the found leaft
-    bfs(graph, farthestNodeFromRoot, distFromNode);
-
-    // find the vertex with the maximal length from the found vertex
-    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
-    {
-        if (distFromNode[vertexIndex] > diameter)
+        findBatchEccentricities(graph, eccentricities->workspaces[threadIndex], sources, sourcesCount, eccentricity);
+        for (i = 0; i < sourcesCount; i++)
         {
-            diameter = distFromNode[vertexIndex];
+            eccentricities->eccentricity[sources[i]] = eccentricity[i];
         }
+        batchIndex = __atomic_fetch_add(&eccentricities->nextBatch, 1, __ATOMIC_RELAXED);
     }
-
-    // delete the distance array
-    free(distFromNode);
-
-    return diameter;
 }
 
 /**
- * @brief Finds the max branch length for a given graph
- * @param graph
- * @param distanceFromNode an reach where value in a given index represents distance from the root
- * @param root
+ * @brief Prints the eccentricity of every vertex of a tree after the radius and the diameter of the tree, in the
+ * format of the eccentricities mode. They are found by the rerooting of the metrics mode, so the lengths are sums of
+ * the weights in a weighted tree
+ * @param graph a tree whose root is set
+ * @param analysis an analysis that already holds the distances from the root and the traversal sources
  * */
-int findMaxBranchLength(Graph *graph, DistanceFromNode distanceFromNode)
+void printTreeEccentricities(Graph *graph, TreeAnalysis *analysis)
 {
-    int maxBranchLength = 0;
-    int vertexIndex;
+    TreeMetrics *metrics = findTreeMetrics(graph, analysis);
+    long long diameter = 0;
+    int vertexKey;
 
-    // goes over each leaf and find the one with the minimal distance from the root
-    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    for (vertexKey = 0; vertexKey < metrics->verticesCount; vertexKey++)
     {
-
-        if ((distanceFromNode[vertexIndex] > maxBranchLength) &&
-            (getVertexDeg(graph, vertexIndex) == 1))
+        if (metrics->eccentricity[vertexKey] > diameter)
         {
-            maxBranchLength = distanceFromNode[vertexIndex];
+            diameter = metrics->eccentricity[vertexKey];
         }
     }
 
-    return maxBranchLength;
-}
+    printf("%s%lld\n", RADIUS_MSG, metrics->radius);
+    printf("%s%lld\n", DIAMETER_LENGTH_MSG, diameter);
+    for (vertexKey = 0; vertexKey < metrics->verticesCount; vertexKey++)
+    {
+        printf("%s%d: %lld\n", ECCENTRICITY_MSG, vertexKey, metrics->eccentricity[vertexKey]);
+    }
 
+    freeTreeMetrics(&metrics);
+}
 
 /**
- * @brief Finds the min branch length for a given graph
- * @param graph
- * @param distanceFromNode an reach where value in a given index represents distance from the root
- * @param root
+ * @brief Prints the eccentricity of every vertex of a general graph within its component, after the radius and the
+ * diameter of the graph. The vertices are traversed from in bit parallel batches, in parallel. The eccentricities of
+ * a tree are found in linear time instead, see printTreeEccentricities.
+ * Expects the arguments --eccentricities <Graph File Path>
+ * @param argv
+ * @return the exit code of the program
  * */
-int findMinBranchLength(Graph *graph, DistanceFromNode distanceFromNode, int root)
+int runEccentricitiesMode(char *argv[])
 {
-    int minBranchLength = graph->verticesCount;
-    int vertexIndex;
+    Graph *graph;
+    TreeAnalysis *analysis;
+    Eccentricities eccentricities;
+    ThreadPool *pool;
+    int threadCount;
+    int radius = INT_MAX;
+    int diameter = 0;
+    int vertexKey, i;
 
-    // case there is only vertex
-    if (graph->verticesCount == 1)
+    if (!readGeneralGraph(argv[MODE_FIRST_ARG_INDEX], 0, &graph))
     {
-        return 0;
+        return EXIT_FAILURE;
     }
 
-    // goes over each leaf and find the one with the minimal distance from the root
-    for (vertexIndex = 0; vertexIndex < graph->verticesCount; vertexIndex++)
+    // a tree, weighted or not, needs no traversal from every vertex
+    analysis = initTreeAnalysis(graph->verticesCount);
+    if (isTree(graph, analysis))
+    {
+        printTreeEccentricities(graph, analysis);
+        freeTreeAnalysis(&analysis);
+        freeGraph(&graph);
+        return EXIT_SUCCESS;
+    }
+    freeTreeAnalysis(&analysis);
+
+    if (graph->weighted)
     {
+        fprintf(stderr, "%s", WEIGHTED_GRAPH_MSG);
+        freeGraph(&graph);
+        return EXIT_FAILURE;
+    }
+
+    eccentricities.graph = initGeneralGraph(graph);
+    freeGraph(&graph);
+    eccentricities.eccentricity = malloc(eccentricities.graph->verticesCount * sizeof(int));
+    eccentricities.sources = malloc(eccentricities.graph->verticesCount * sizeof(int));
+    for (i = 0, vertexKey = 0; i < eccentricities.graph->componentsCount; i++)
+    {
+        findGeneralBfs(eccentricities.graph, eccentricities.graph->componentStarts[i]);
+        memcpy(eccentricities.sources + vertexKey, eccentricities.graph->order,
+               eccentricities.graph->orderCount * sizeof(int));
+        vertexKey += eccentricities.graph->orderCount;
+    }
+    eccentricities.batchesCount = (eccentricities.graph->verticesCount + BIT_PARALLEL_SOURCES - 1) /
+                                  BIT_PARALLEL_SOURCES;
+    eccentricities.nextBatch = 0;
+
+    // a thread without a batch would only hold idle buffers
+    threadCount = getThreadCount();
+    if (threadCount > eccentricities.batchesCount)
+    {
+        threadCount = eccentricities.batchesCount;
+    }
+    eccentricities.workspaces = malloc(threadCount * sizeof(BitParallelBfs *));
+    for (i = 0; i < threadCount; i++)
+    {
+        eccentricities.workspaces[i] = initBitParallelBfs(eccentricities.graph->verticesCount);
+    }
 
-        if ((distanceFromNode[vertexIndex] < minBranchLength) &&
-            (getVertexDeg(graph, vertexIndex) == 1) && vertexIndex != root)
+    pool = initThreadPool(threadCount);
+    runParallel(pool, eccentricitiesTask, &eccentricities);
+    freeThreadPool(&pool);
+
+    for (vertexKey = 0; vertexKey < eccentricities.graph->verticesCount; vertexKey++)
+    {
+        if (eccentricities.eccentricity[vertexKey] < radius)
         {
-            minBranchLength = distanceFromNode[vertexIndex];
+            radius = eccentricities.eccentricity[vertexKey];
+        }
+        if (eccentricities.eccentricity[vertexKey] > diameter)
+        {
+            diameter = eccentricities.eccentricity[vertexKey];
         }
     }
 
-    return minBranchLength;
-}
+    printf("%s%d\n", RADIUS_MSG, radius);
+    printf("%s%d\n", DIAMETER_LENGTH_MSG, diameter);
+    for (vertexKey = 0; vertexKey < eccentricities.graph->verticesCount; vertexKey++)
+    {
+        printf("%s%d: %d\n", ECCENTRICITY_MSG, vertexKey, eccentricities.eccentricity[vertexKey]);
+    }
 
+    for (i = 0; i < threadCount; i++)
+    {
+        freeBitParallelBfs(&eccentricities.workspaces[i]);
+    }
+    free(eccentricities.workspaces);
+    free(eccentricities.eccentricity);
+    free(eccentricities.sources);
+    freeGeneralGraph(&eccentricities.graph);
+    return EXIT_SUCCESS;
+}
 
 /**
- * @brief Prints a given graph graph info regarding diameter,max branch length and min  branch length
- * @param graph
+ * @brief Find the amount of threads to use for parallel work. It is the amount of online processors, unless it is
+ * overridden by the TREE_ANALYZER_THREADS environment variable
  * */
-void printTreeDistanceInfo(Graph *graph)
+int getThreadCount()
 {
+    char *threadsVariable = getenv(THREADS_ENV_VAR);
+    long threadCount;
 
-    DistanceFromNode distFromNode = calloc(graph->verticesCount, sizeof(int));
-
-    int root = graph->root;
-    int minBranchLength, maxBranchLength;
-    int diameter = 0;
-
-    // find the distance
-    bfs(graph, root, distFromNode);
-
-    // find out the min/max branches length
-    maxBranchLength = findMaxBranchLength(graph, distFromNode);
-    minBranchLength = findMinBranchLength(graph, distFromNode, root);
-
-    // find out the diameter of the graph
-    diameter = findGraphDiameter(graph, root);
+    if ((threadsVariable != NULL) && (*threadsVariable != '\0') && (nonNumerical(threadsVariable) == 0))
+    {
+        threadCount = strtol(threadsVariable, NULL, 10);
+    }
+    else
+    {
+        threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    }
 
-    // print the results to the terminal
-    printf("%s%d\n", MINIMAL_BRACH_LENGTH_MSG, minBranchLength);
-    printf("%s%d\n", MAXIMAL_BRACH_LENGTH_MSG, maxBranchLength);
-    printf("%s%d\n", DIAMETER_LENGTH_MSG, diameter);
+    if (threadCount < 1)
+    {
+        return 1;
+    }
 
-    // delete the distance array
-    free(distFromNode);
+    return (threadCount > MAX_THREADS) ? MAX_THREADS : (int) threadCount;
 }
 
 /**
- * @brief Prints the shortest path between two vertices in graph
- * @param uVertexKey  the path start vertex
- * @param vVertexKey the  path end vertex
+ * @brief The loop of a worker thread in a thread pool. Waits for tasks and runs its share of them
+ * @param workerArgs the WorkerArgs of the thread
  * */
-void printShortestPath(Graph *graph, int uVertexKey, int vVertexKey)
+void *runWorker(void *workerArgs)
 {
+    WorkerArgs *worker = (WorkerArgs *) workerArgs;
+    ThreadPool *pool = worker->pool;
+    unsigned long seenGeneration = 0;
+    ParallelTask task;
+    void *taskArgs;
+
+    pthread_mutex_lock(&pool->lock);
+    while (true)
+    {
+        // wait for a task which was not run yet
+        while ((pool->generation == seenGeneration) && (!pool->stopping))
+        {
+            pthread_cond_wait(&pool->taskReady, &pool->lock);
+        }
 
-    // represents the distance from node v
-    DistanceFromNode distArray = calloc(graph->verticesCount, sizeof(int));
-
-    int currentVertexKey = uVertexKey;
-    int currentDist = graph->verticesCount;
-    Vertex *adjVertexPtr;
-
-    // perform bfs to fill the distance array
-    bfs(graph, vVertexKey, distArray);
-
-    // print the path to the terminal
-    printf("Shortest Path Between %d and %d:", uVertexKey, vVertexKey);
+        if (pool->stopping)
+        {
+            break;
+        }
 
-    // print each vertex index
-    while (currentVertexKey != vVertexKey)
-    {
+        seenGeneration = pool->generation;
+        task = pool->task;
+        taskArgs = pool->taskArgs;
+        pthread_mutex_unlock(&pool->lock);
 
-        printf(" %d", currentVertexKey);
-        adjVertexPtr = graph->listOfAdjacent[currentVertexKey];
+        task(taskArgs, worker->threadIndex, pool->threadCount);
 
-        // navigate to the next vertex ehich decrease the length of the path
-        while (adjVertexPtr)
+        // the last worker to finish wakes the thread waiting for the task
+        pthread_mutex_lock(&pool->lock);
+        pool->runningWorkers--;
+        if (pool->runningWorkers == 0)
         {
-            if (currentDist > distArray[adjVertexPtr->vertexKey])
-            {
-                currentDist = distArray[adjVertexPtr->vertexKey];
-                currentVertexKey = adjVertexPtr->vertexKey;
-            }
-            adjVertexPtr = adjVertexPtr->next;
+            pthread_cond_signal(&pool->taskDone);
         }
     }
+    pthread_mutex_unlock(&pool->lock);
 
-    //  end the row
-    printf(" %d\n", vVertexKey);
-
-    // delete the distance array
-    free(distArray);
-};
+    return NULL;
+}
 
 /**
- * @brief Prints the full analysis for a graph
- * @param uVertexKey  the path start vertex
- * @param vVertexKey the  path end vertex
+ * @brief Initialize a thread pool with a given amount of threads, including the calling thread
+ * @param threadCount
  * */
-void printTreeInfo(Graph *graph, int uVertexKey, int vVertexKey)
+ThreadPool *initThreadPool(int threadCount)
 {
+    ThreadPool *pool = malloc(sizeof(ThreadPool));
+    int i;
 
-    // prints info of the root the graph
-    printf("%s%d\n", ROOT_VERTEX_MSG, graph->root);
-
-    // Displays the total vertices number
-    printf("%s%d\n", VERTICES_COUNT_MSG, graph->verticesCount);
-
-    // Displays the total edges number
-    printf("%s%d\n", EDGES_COUNT_MSG, graph->edgesCount);
+    pool->threadCount = threadCount;
+    pool->threads = malloc(threadCount * sizeof(pthread_t));
+    pool->workers = malloc(threadCount * sizeof(WorkerArgs));
+    pool->task = NULL;
+    pool->taskArgs = NULL;
+    pool->generation = 0;
+    pool->runningWorkers = 0;
+    pool->stopping = false;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->taskReady, NULL);
+    pthread_cond_init(&pool->taskDone, NULL);
+
+    // the calling thread is worker 0
+    for (i = 1; i < threadCount; i++)
+    {
+        pool->workers[i].pool = pool;
+        pool->workers[i].threadIndex = i;
+        pthread_create(&pool->threads[i], NULL, runWorker, &pool->workers[i]);
+    }
 
-    // prints info regarding the distance of the tree
-    printTreeDistanceInfo(graph);
+    return pool;
+}
 
-    // print the shortest path between the given vertex
-    printShortestPath(graph, uVertexKey, vVertexKey);
-};
+/**
+ * @brief Runs a task on every thread of a pool, including the calling thread, and waits for all of them
+ * @param pool
+ * @param task called with the index of the thread and the amount of threads
+ * @param taskArgs passed to the task
+ * */
+void runParallel(ThreadPool *pool, ParallelTask task, void *taskArgs)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->taskArgs = taskArgs;
+    pool->runningWorkers = pool->threadCount - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->taskReady);
+    pthread_mutex_unlock(&pool->lock);
+
+    task(taskArgs, 0, pool->threadCount);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->runningWorkers > 0)
+    {
+        pthread_cond_wait(&pool->taskDone, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
 
 /**
- * @brief Release the of a given array of strings
- * @param content a given array of strings
- * @param length the length of content
+ * @brief Stops the threads of a pool and release its memory
+ * @param poolPtr
  * */
-void freeContent(char **content, int length)
+void freeThreadPool(ThreadPool **poolPtr)
 {
+    ThreadPool *pool = *poolPtr;
     int i;
 
-    // delete each item in the array
-    for (i = 0; i < length; i++)
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->taskReady);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (i = 1; i < pool->threadCount; i++)
     {
-        free(content[i]);
+        pthread_join(pool->threads[i], NULL);
     }
 
-    // delete the array
-    free(content);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->taskReady);
+    pthread_cond_destroy(&pool->taskDone);
+    free(pool->threads);
+    free(pool->workers);
+    free(pool);
+    *poolPtr = NULL;
 }
 
+/**
+ * @brief Find the range of a given length which a thread handles when the work is split evenly between threads
+ * @param length the total length of the work
+ * @param threadIndex
+ * @param threadCount
+ * @param start set to the first index the thread handles
+ * @param end set to one after the last index the thread handles
+ * */
+void getThreadRange(long length, int threadIndex, int threadCount, long *start, long *end)
+{
+    *start = length * threadIndex / threadCount;
+    *end = length * (threadIndex + 1) / threadCount;
+}
 
 /**
- * @brief Release the memory allocated to edges on a given graph
- * @param graphPtr
+ * @brief Initialize the state of a parallel bfs over a given graph
+ * @param graph
+ * @param threadCount the amount of threads to traverse with
  * */
-void deleteAllEdges(Graph **graphPtr)
+ParallelBfs *initParallelBfs(Graph *graph, int threadCount)
 {
-    Graph *graph = *graphPtr;
+    ParallelBfs *traversal = malloc(sizeof(ParallelBfs));
     int verticesCount = graph->verticesCount;
-    Vertex *currentNode;
-    Vertex *temp;
-    int i;
 
-    // delete all edges
-    for (i = 0; i < verticesCount; i++)
-    {
-        currentNode = graph->listOfAdjacent[i];
+    traversal->verticesCount = verticesCount;
+    traversal->wordsCount = (verticesCount + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    traversal->pool = initThreadPool(threadCount);
 
-        while (currentNode != NULL)
-        {
-            temp = currentNode->next;
-            free(currentNode);
-            currentNode = temp;
-        }
-    }
+    traversal->adjacencyOffsets = malloc((verticesCount + 1) * sizeof(int));
+    traversal->adjacency = malloc(2 * (size_t) graph->edgesCount * sizeof(int));
+    buildAdjacencyArrays(graph, traversal->adjacencyOffsets, traversal->adjacency);
 
+    traversal->visited = malloc(traversal->wordsCount * sizeof(uint64_t));
+    traversal->frontier = malloc(traversal->wordsCount * sizeof(uint64_t));
+    traversal->nextFrontier = malloc(traversal->wordsCount * sizeof(uint64_t));
+    traversal->queue = malloc(verticesCount * sizeof(int));
+    traversal->nextQueue = malloc(verticesCount * sizeof(int));
+    traversal->threadEdges = malloc(threadCount * sizeof(long));
 
+    return traversal;
 }
 
 /**
- * @brief Release the memory allocated to a given graph
- * @param graphPtr
+ * @brief Release the memory allocated to a parallel bfs and stop its threads
+ * @param traversalPtr
  * */
-void freeGraph(Graph **graphPtr)
+void freeParallelBfs(ParallelBfs **traversalPtr)
 {
+    ParallelBfs *traversal = *traversalPtr;
+
+    freeThreadPool(&traversal->pool);
+    free(traversal->adjacencyOffsets);
+    free(traversal->adjacency);
+    free(traversal->visited);
+    free(traversal->frontier);
+    free(traversal->nextFrontier);
+    free(traversal->queue);
+    free(traversal->nextQueue);
+    free(traversal->threadEdges);
+    free(traversal);
+    *traversalPtr = NULL;
+}
 
-    // deletes all the edges
-    deleteAllEdges(graphPtr);
+/**
+ * @brief Find the degree of a vertex in the adjacency arrays of a parallel bfs
+ * @param traversal
+ * @param vertexKey
+ * */
+int getParallelBfsDeg(ParallelBfs *traversal, int vertexKey)
+{
+    return traversal->adjacencyOffsets[vertexKey + 1] - traversal->adjacencyOffsets[vertexKey];
+}
 
-    // deletes the list of vertices
-    free((*graphPtr)->listOfAncestors);
-    free((*graphPtr)->listOfAdjacent);
+/**
+ * @brief Checks whenever a vertex is set in a given bitmap
+ * @param bitmap
+ * @param vertexKey
+ * */
+bool isBitSet(uint64_t *bitmap, int vertexKey)
+{
+    return (__atomic_load_n(&bitmap[vertexKey / BITS_PER_WORD], __ATOMIC_RELAXED) >>
+                                                                                  (vertexKey % BITS_PER_WORD)) & 1;
+}
 
-    // deletes the visited list of every vertex
-    free((*graphPtr)->visited);
-    free((*graphPtr));
+/**
+ * @brief Sets a vertex in a bitmap shared between threads
+ * @param bitmap
+ * @param vertexKey
+ * @return true when this call set the vertex, false when it was already set
+ * */
+bool setBitAtomic(uint64_t *bitmap, int vertexKey)
+{
+    uint64_t mask = ((uint64_t) 1) << (vertexKey % BITS_PER_WORD);
 
+    return (__atomic_fetch_or(&bitmap[vertexKey / BITS_PER_WORD], mask, __ATOMIC_RELAXED) & mask) == 0;
 }
 
-
 /**
- * @brief Find whenever a number is contained in a given string
- * @param str A given string
+ * @brief A top down step on the calling thread, used while the frontier is too small to be split between threads
+ * @param traversal
  * */
-bool containsNumber(char *str)
+void topDownStepSequential(ParallelBfs *traversal)
 {
-    return nonNumerical(str) != ((int) strlen(str));
+    int nextDist = traversal->level + 1;
+    long frontierEdges = 0;
+    int i, edge, adjVertex;
+
+    traversal->nextQueueSize = 0;
+    for (i = 0; i < traversal->queueSize; i++)
+    {
+        for (edge = traversal->adjacencyOffsets[traversal->queue[i]];
+             edge < traversal->adjacencyOffsets[traversal->queue[i] + 1]; edge++)
+        {
+            adjVertex = traversal->adjacency[edge];
+            if (setBitAtomic(traversal->visited, adjVertex))
+            {
+                traversal->dist[adjVertex] = nextDist;
+                traversal->nextQueue[traversal->nextQueueSize++] = adjVertex;
+                frontierEdges += getParallelBfsDeg(traversal, adjVertex);
+            }
+        }
+    }
+    traversal->frontierEdges = frontierEdges;
 }
 
 /**
- * @brief Find the total non numerical characters in a given string
- * @param str A given string
- * @return total non numerical values
+ * @brief The share of a single thread in a top down step: visits the unvisited neighbors of its part of the
+ * frontier. Vertices are claimed with an atomic operation on the visited bitmap
+ * @param traversalArgs the ParallelBfs
+ * @param threadIndex
+ * @param threadCount
  * */
-int nonNumerical(char *str)
+void topDownStepTask(void *traversalArgs, int threadIndex, int threadCount)
 {
-    int i;
-    int length = (int) strlen(str);
-    int nonNumericalTotal = 0;
+    ParallelBfs *traversal = (ParallelBfs *) traversalArgs;
+    int nextDist = traversal->level + 1;
+    long frontierEdges = 0;
+    long start, end, i;
+    int edge, adjVertex, queueIndex;
+
+    getThreadRange(traversal->queueSize, threadIndex, threadCount, &start, &end);
+    for (i = start; i < end; i++)
+    {
+        for (edge = traversal->adjacencyOffsets[traversal->queue[i]];
+             edge < traversal->adjacencyOffsets[traversal->queue[i] + 1]; edge++)
+        {
+            adjVertex = traversal->adjacency[edge];
+            if (isBitSet(traversal->visited, adjVertex) || !setBitAtomic(traversal->visited, adjVertex))
+            {
+                continue;
+            }
 
-    for (i = 0; i < length; i++)
+            traversal->dist[adjVertex] = nextDist;
+            queueIndex = __atomic_fetch_add(&traversal->nextQueueSize, 1, __ATOMIC_RELAXED);
+            traversal->nextQueue[queueIndex] = adjVertex;
+            frontierEdges += getParallelBfsDeg(traversal, adjVertex);
+        }
+    }
+    traversal->threadEdges[threadIndex] = frontierEdges;
+}
+
+/**
+ * @brief The share of a single thread in a bottom up step: every unvisited vertex in its range looks for a
+ * neighbor in the frontier. The range is aligned to bitmap words, so the thread owns the words it writes
+ * @param traversalArgs the ParallelBfs
+ * @param threadIndex
+ * @param threadCount
+ * */
+void bottomUpStepTask(void *traversalArgs, int threadIndex, int threadCount)
+{
+    ParallelBfs *traversal = (ParallelBfs *) traversalArgs;
+    int nextDist = traversal->level + 1;
+    long frontierEdges = 0;
+    long startWord, endWord, word;
+    int vertexKey, lastVertexKey, edge, queueIndex;
+    uint64_t mask;
+
+    getThreadRange(traversal->wordsCount, threadIndex, threadCount, &startWord, &endWord);
+    for (word = startWord; word < endWord; word++)
     {
-        if (!isdigit(str[i]))
+        traversal->nextFrontier[word] = 0;
+        vertexKey = (int) (word * BITS_PER_WORD);
+        lastVertexKey = vertexKey + BITS_PER_WORD;
+        if (lastVertexKey > traversal->verticesCount)
         {
-            nonNumericalTotal++;
+            lastVertexKey = traversal->verticesCount;
         }
 
-    }
+        for (; vertexKey < lastVertexKey; vertexKey++)
+        {
+            mask = ((uint64_t) 1) << (vertexKey % BITS_PER_WORD);
+            if (traversal->visited[word] & mask)
+            {
+                continue;
+            }
 
-    return nonNumericalTotal;
+            // stop at the first neighbor in the frontier
+            for (edge = traversal->adjacencyOffsets[vertexKey];
+                 edge < traversal->adjacencyOffsets[vertexKey + 1]; edge++)
+            {
+                if (isBitSet(traversal->frontier, traversal->adjacency[edge]))
+                {
+                    break;
+                }
+            }
+
+            if (edge == traversal->adjacencyOffsets[vertexKey + 1])
+            {
+                continue;
+            }
+
+            traversal->visited[word] |= mask;
+            traversal->nextFrontier[word] |= mask;
+            traversal->dist[vertexKey] = nextDist;
+            queueIndex = __atomic_fetch_add(&traversal->nextQueueSize, 1, __ATOMIC_RELAXED);
+            traversal->nextQueue[queueIndex] = vertexKey;
+            frontierEdges += getParallelBfsDeg(traversal, vertexKey);
+        }
+    }
+    traversal->threadEdges[threadIndex] = frontierEdges;
 }
 
 /**
- * @brief Find the maximal number in a give given string
- * @param str A given string
- * @return maximal number in the string
+ * @brief The share of a single thread in converting the frontier list to the frontier bitmap
+ * @param traversalArgs the ParallelBfs
+ * @param threadIndex
+ * @param threadCount
  * */
-int getMaxValueFromString(char *str)
+void fillFrontierTask(void *traversalArgs, int threadIndex, int threadCount)
 {
-    char *end = str;
-    int currentIntegerValue;
-    int base = 10;
-    int maxIntegerValue = 0;
+    ParallelBfs *traversal = (ParallelBfs *) traversalArgs;
+    long start, end, i;
 
-    // iterate over each number and compares it to the current number found
-    while (containsNumber(end))
+    getThreadRange(traversal->queueSize, threadIndex, threadCount, &start, &end);
+    for (i = start; i < end; i++)
     {
+        setBitAtomic(traversal->frontier, traversal->queue[i]);
+    }
+}
+
+/**
+ * @brief The share of a single thread in finding the traversal source of every reached vertex. In a tree it is
+ * the only neighbor which is closer to the start vertex
+ * @param traversalArgs the ParallelBfs
+ * @param threadIndex
+ * @param threadCount
+ * */
+void fillSourcesTask(void *traversalArgs, int threadIndex, int threadCount)
+{
+    ParallelBfs *traversal = (ParallelBfs *) traversalArgs;
+    long start, end, vertexKey;
+    int edge, adjVertex;
 
-        currentIntegerValue = (int) strtol(end, &end, base);
-        if (maxIntegerValue < currentIntegerValue)
+    getThreadRange(traversal->verticesCount, threadIndex, threadCount, &start, &end);
+    for (vertexKey = start; vertexKey < end; vertexKey++)
+    {
+        traversal->traverseSource[vertexKey] = -1;
+        if (!isBitSet(traversal->visited, (int) vertexKey) || (traversal->dist[vertexKey] == 0))
         {
-            maxIntegerValue = currentIntegerValue;
+            continue;
         }
 
-        end++;
+        for (edge = traversal->adjacencyOffsets[vertexKey]; edge < traversal->adjacencyOffsets[vertexKey + 1]; edge++)
+        {
+            adjVertex = traversal->adjacency[edge];
+            if (isBitSet(traversal->visited, adjVertex) &&
+                (traversal->dist[adjVertex] == traversal->dist[vertexKey] - 1))
+            {
+                traversal->traverseSource[vertexKey] = adjVertex;
+                break;
+            }
+        }
     }
-
-    return maxIntegerValue;
 }
 
 /**
- * @brief checks whenever an array contains only digits and spaces
- * @param str A given string
- * @return
+ * @brief Performs a direction optimizing bfs on the threads of a pool. Each level is expanded top down from the
+ * frontier while it is small, and bottom up from the unvisited vertices once the frontier has more edges than
+ * the unvisited part of the graph. Small frontiers are expanded on the calling thread alone, so deep and narrow
+ * trees do not pay for synchronizing the threads on every level.
+ * @param traversal
+ * @param startVertexKey the vertex to start the traversal from
+ * @param distFromVertex filled with the distance of every reached vertex from the start vertex
+ * @param traverseSource filled with the vertex from which every vertex was reached, -1 for the start vertex
+ * @return the amount of reached vertices
  * */
-bool onlyDigitsAndSpaces(char *str)
+int parallelBfs(ParallelBfs *traversal, int startVertexKey, DistanceFromNode distFromVertex, int *traverseSource)
 {
-    char *c = str;
+    long unexploredEdges = traversal->adjacencyOffsets[traversal->verticesCount];
+    bool bottomUp = false;
+    int reachedCount = 1;
+    int *tempQueue;
+    uint64_t *tempFrontier;
+    int i;
 
-    // iterates over each character
-    while (*c)
+    memset(traversal->visited, 0, traversal->wordsCount * sizeof(uint64_t));
+    traversal->dist = distFromVertex;
+    traversal->traverseSource = traverseSource;
+    traversal->level = 0;
+
+    // the start vertex is the first frontier
+    distFromVertex[startVertexKey] = 0;
+    setBitAtomic(traversal->visited, startVertexKey);
+    traversal->queue[0] = startVertexKey;
+    traversal->queueSize = 1;
+    traversal->frontierEdges = getParallelBfsDeg(traversal, startVertexKey);
+
+    while (traversal->queueSize > 0)
     {
-        if (!(isdigit(*c) || *c == ' '))
+        // choose the direction of the step. The bitmap of the frontier is only built when switching to bottom up
+        if ((!bottomUp) && (traversal->queueSize >= SEQUENTIAL_STEP_MAX_FRONTIER) &&
+            (traversal->frontierEdges > unexploredEdges / TOP_DOWN_ALPHA))
         {
-            return false;
+            bottomUp = true;
+            memset(traversal->frontier, 0, traversal->wordsCount * sizeof(uint64_t));
+            runParallel(traversal->pool, fillFrontierTask, traversal);
+        }
+        else if (bottomUp && (traversal->queueSize < traversal->verticesCount / BOTTOM_UP_BETA))
+        {
+            bottomUp = false;
+        }
+        unexploredEdges -= traversal->frontierEdges;
+
+        traversal->nextQueueSize = 0;
+        if ((!bottomUp) && (traversal->queueSize < SEQUENTIAL_STEP_MAX_FRONTIER))
+        {
+            topDownStepSequential(traversal);
         }
-        c++;
+        else
+        {
+            runParallel(traversal->pool, bottomUp ? bottomUpStepTask : topDownStepTask, traversal);
+
+            traversal->frontierEdges = 0;
+            for (i = 0; i < traversal->pool->threadCount; i++)
+            {
+                traversal->frontierEdges += traversal->threadEdges[i];
+            }
+        }
+
+        // the next frontier becomes the current one
+        tempQueue = traversal->queue;
+        traversal->queue = traversal->nextQueue;
+        traversal->nextQueue = tempQueue;
+        traversal->queueSize = traversal->nextQueueSize;
+        tempFrontier = traversal->frontier;
+        traversal->frontier = traversal->nextFrontier;
+        traversal->nextFrontier = tempFrontier;
+
+        reachedCount += traversal->queueSize;
+        traversal->level++;
     }
 
-    return true;
+    runParallel(traversal->pool, fillSourcesTask, traversal);
+
+    return reachedCount;
 }
@@ -0,0 +1,81 @@
+#!/bin/sh
+# Regression tests of TreeAnalyzer. Builds it and compares the output of every case with the expected one.
+# Run from any directory: sh ex2/tests/run_tests.sh
+
+DIR=$(cd "$(dirname "$0")/.." && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+FAILED=0
+
+gcc -O2 -std=c99 -Wall -Wextra "$DIR/TreeAnalyzer.c" -o "$WORK/TreeAnalyzer" -lpthread || exit 1
+
+# expect <name> <expected output, stdout and stderr> <arguments...>
+expect()
+{
+    name=$1
+    expected=$2
+    shift 2
+    actual=$("$WORK/TreeAnalyzer" "$@" 2>&1)
+    if [ "$actual" != "$expected" ]; then
+        printf 'FAIL %s\n--- expected\n%s\n--- actual\n%s\n' "$name" "$expected" "$actual"
+        FAILED=1
+    fi
+}
+
+# a run of spaces ending a row adds edges to vertex 0, which are checked as edges of the tree
+printf '10\n-\n8 \n8 3\n-\n8\n-\n1\n5  \n-\n3 5\n' > "$WORK/stray.txt"
+expect "stray edges form a tree" "Root Vertex: 7
+Vertices Count: 10
+Edges Count: 9
+Length of Minimal Branch: 1
+Length of Maximal Branch: 7
+Diameter Length: 8
+Shortest Path Between 6 and 8: 6 1 8" "$WORK/stray.txt" 6 8
+
+printf '3\n1 2  \n-\n-\n' > "$WORK/strayCycle.txt"
+expect "stray edge closing a cycle" "The given graph is not a tree" "$WORK/strayCycle.txt" 0 1
+
+# a binary graph file is rejected when it is too short for the rows its header asks for
+printf '3\n1 2\n-\n-\n' > "$WORK/path.txt"
+"$WORK/TreeAnalyzer" --convert "$WORK/path.txt" "$WORK/path.bin"
+expect "binary graph" "Root Vertex: 0
+Vertices Count: 3
+Edges Count: 2
+Length of Minimal Branch: 1
+Length of Maximal Branch: 1
+Diameter Length: 2
+Shortest Path Between 1 and 2: 1 0 2" "$WORK/path.bin" 1 2
+
+head -c 18 "$WORK/path.bin" > "$WORK/truncated.bin"
+expect "truncated binary graph" "Invalid input" "$WORK/truncated.bin" 1 2
+
+printf 'TREEBIN\000\001\000\000\000\377\377\377\177\002\002\002\000\000' > "$WORK/inflated.bin"
+expect "inflated binary header" "Invalid input" "$WORK/inflated.bin" 1 2
+
+# the metrics of a weighted tree sum the weights of the edges, and a weight must be strictly positive
+printf '4\n1:5 2:7\n3:2\n-\n-\n' > "$WORK/weighted.txt"
+expect "weighted metrics" "Root Vertex: 0
+Vertices Count: 4
+Edges Count: 3
+Length of Minimal Branch: 7
+Length of Maximal Branch: 7
+Diameter Length: 14
+Radius: 7
+Center: 0
+Centroid: 0 1
+Eccentricities: 7 12 14 14
+Subtree Sizes: 4 2 1 1
+Width Per Depth: 1 2 1" --metrics "$WORK/weighted.txt"
+
+printf '3\n1:0 2:0\n-\n-\n' > "$WORK/zeroWeights.txt"
+expect "zero weights" "Invalid input" --metrics "$WORK/zeroWeights.txt"
+
+# a benchmark smaller than its smallest tree is a usage error
+expect "benchmark below its minimal size" "Usage: TreeAnalyzer --benchmark <Tree Kind> <Max Vertices Count> <Graph File Path>
+Tree kinds: path, star, kary-<k>, prufer, caterpillar, near-tree
+The max vertices count is at least 1000" --benchmark path 999 "$WORK/benchmark.txt"
+
+if [ $FAILED -eq 0 ]; then
+    echo "all tests passed"
+fi
+exit $FAILED